@@ -7,6 +7,7 @@
 
 #include <chrono>
 
+template<class Duration>
 class Stopwatch {
 public:
     static Stopwatch Start() {
@@ -17,14 +18,14 @@ public:
 
     long long Split() {
         end = std::chrono::steady_clock::now();
-        const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count();
+        const auto duration = std::chrono::duration_cast<Duration>(end - begin).count();
         begin = std::chrono::steady_clock::now();
         return duration;
     }
 
     long long Stop() {
         end = std::chrono::steady_clock::now();
-        return std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count();
+        return std::chrono::duration_cast<Duration>(end - begin).count();
     }
 
     void Restart() {
@@ -0,0 +1,117 @@
+//
+// Created by Jost on 17/10/2026.
+//
+
+#include "batch_queries.h"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include "buffered_writer.h"
+#include "query_workspace.h"
+
+namespace exercise::one {
+    // queries are handed out to the threads in small blocks, so slow long-distance queries don't stall a thread
+    // with a big static share while the others are idle
+    constexpr size_t QUERY_BLOCK_SIZE = 64;
+
+    std::vector<Query> parse_query_file(const MappedFile &query_file) {
+        std::vector<Query> queries;
+
+        const char *cursor = query_file.data();
+        const char *end = cursor + query_file.size();
+        while (cursor < end) {
+            const auto line_end_ptr = static_cast<const char *>(std::memchr(cursor, '\n', end - cursor));
+            const auto line_end = line_end_ptr == nullptr ? end : line_end_ptr;
+
+            int source, target;
+            const auto source_result = std::from_chars(cursor, line_end, source);
+            if (source_result.ec == std::errc()) {
+                const auto target_start = std::find_if(source_result.ptr, line_end, [](const char c) {
+                    return c != ' ';
+                });
+                if (std::from_chars(target_start, line_end, target).ec == std::errc()) {
+                    queries.push_back(Query{source, target});
+                }
+            }
+
+            cursor = line_end + 1;
+        }
+
+        return queries;
+    }
+
+    static long long percentile(const std::vector<long long> &sorted_values, const double fraction) {
+        if (sorted_values.empty())
+            return 0;
+
+        const auto index = static_cast<size_t>(fraction * static_cast<double>(sorted_values.size() - 1));
+        return sorted_values[index];
+    }
+
+    BatchStatistics handle_query_batch(const Graph &graph, const std::vector<Query> &queries,
+                                       const std::string &result_file_name, int thread_count) {
+        thread_count = std::max(1, thread_count);
+
+        std::vector<int> distances(queries.size());
+        std::vector<long long> latencies(queries.size());
+        std::atomic<size_t> next_block{0};
+
+        const auto start = std::chrono::steady_clock::now();
+        {
+            std::vector<std::thread> threads;
+            threads.reserve(thread_count);
+            for (int i = 0; i < thread_count; ++i) {
+                threads.emplace_back([&graph, &queries, &distances, &latencies, &next_block]() {
+                    QueryWorkspace<> workspace(graph.get_node_count());
+                    while (true) {
+                        const auto block_start = next_block.fetch_add(QUERY_BLOCK_SIZE);
+                        if (block_start >= queries.size())
+                            break;
+
+                        const auto block_end = std::min(block_start + QUERY_BLOCK_SIZE, queries.size());
+                        for (auto j = block_start; j < block_end; ++j) {
+                            const auto query_start = std::chrono::steady_clock::now();
+                            distances[j] = graph.compute_shortest_path_dijkstra(queries[j].source,
+                                                                                queries[j].target, workspace);
+                            latencies[j] = std::chrono::duration_cast<std::chrono::microseconds>(
+                                std::chrono::steady_clock::now() - query_start).count();
+                        }
+                    }
+                });
+            }
+            for (auto &thread: threads) {
+                thread.join();
+            }
+        }
+        const auto total_time = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count();
+
+        // results are written in input order, the time column stays in milliseconds like the sequential mode
+        BufferedWriter result_file(result_file_name);
+        for (size_t i = 0; i < queries.size(); ++i) {
+            result_file << queries[i].source << ' ' << queries[i].target << ' ' << distances[i] << ' '
+                    << latencies[i] / 1000 << '\n';
+        }
+        result_file.close();
+
+        BatchStatistics statistics;
+        statistics.query_count = static_cast<int>(queries.size());
+        statistics.thread_count = thread_count;
+        statistics.total_time_us = total_time;
+        statistics.queries_per_second = static_cast<double>(queries.size()) * 1e6 /
+                                        static_cast<double>(std::max(1LL, static_cast<long long>(total_time)));
+
+        std::sort(latencies.begin(), latencies.end());
+        statistics.latency_p50_us = percentile(latencies, 0.5);
+        statistics.latency_p90_us = percentile(latencies, 0.9);
+        statistics.latency_p99_us = percentile(latencies, 0.99);
+        statistics.latency_max_us = latencies.empty() ? 0 : latencies.back();
+
+        return statistics;
+    }
+} // exercise::one
@@ -0,0 +1,42 @@
+//
+// Created by Jost on 17/10/2026.
+//
+
+#ifndef BATCH_QUERIES_H
+#define BATCH_QUERIES_H
+
+#include <string>
+#include <vector>
+
+#include "graph.h"
+#include "mapped_file.h"
+
+namespace exercise::one {
+    struct Query {
+        int source;
+        int target;
+    };
+
+    struct BatchStatistics {
+        int query_count = 0;
+        int thread_count = 0;
+        long long total_time_us = 0;
+        double queries_per_second = 0;
+
+        // latency percentiles of the single queries
+        long long latency_p50_us = 0;
+        long long latency_p90_us = 0;
+        long long latency_p99_us = 0;
+        long long latency_max_us = 0;
+    };
+
+    /// Reads the "source target" lines of a query file
+    std::vector<Query> parse_query_file(const MappedFile &query_file);
+
+    /// Answers all queries on thread_count threads, each with its own query workspace, and writes the
+    /// "source target distance time" lines in input order to the result file
+    BatchStatistics handle_query_batch(const Graph &graph, const std::vector<Query> &queries,
+                                       const std::string &result_file_name, int thread_count);
+} // exercise::one
+
+#endif //BATCH_QUERIES_H
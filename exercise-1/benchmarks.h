@@ -0,0 +1,350 @@
+//
+// Created by Jost on 17/10/2026.
+//
+
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "batch_queries.h"
+#include "csr_builder.h"
+#include "geometric_a_star.h"
+#include "graph.h"
+#include "landmarks.h"
+#include "mapped_file.h"
+#include "parse_fmi_file.h"
+#include "priority_queues.h"
+#include "query_workspace.h"
+#include "Stopwatch.h"
+
+namespace exercise::one {
+    inline bool equal_edges(const std::vector<FMIEdge> &a, const std::vector<FMIEdge> &b) {
+        if (a.size() != b.size())
+            return false;
+
+        for (size_t i = 0; i < a.size(); ++i) {
+            if (a[i].from != b[i].from || a[i].to != b[i].to || a[i].weight != b[i].weight)
+                return false;
+        }
+        return true;
+    }
+
+    inline bool equal_nodes(const FMINodes &a, const FMINodes &b) {
+        return a.latitudes == b.latitudes && a.longitudes == b.longitudes;
+    }
+
+    inline void benchmark_loading(const std::string &graph_file_name) {
+        const int thread_count = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        std::cout << "[BENCHMARK] Loading '" << graph_file_name << "' with " << thread_count << " threads"
+                  << std::endl;
+
+        auto sw = Stopwatch<std::chrono::milliseconds>::Start();
+
+        // parsing only
+        FMINodes stream_nodes;
+        std::vector<FMIEdge> stream_edges;
+        sw.Restart();
+        parse_fmi_file(std::fstream(graph_file_name, std::ios::in), stream_nodes, stream_edges);
+        const auto stream_time = sw.Stop();
+
+        FMINodes mapped_single_nodes;
+        std::vector<FMIEdge> mapped_single_edges;
+        sw.Restart();
+        {
+            const MappedFile mapped_file(graph_file_name);
+            parse_fmi_file(mapped_file, mapped_single_nodes, mapped_single_edges, 1);
+        }
+        const auto mapped_single_time = sw.Stop();
+
+        FMINodes mapped_nodes;
+        std::vector<FMIEdge> mapped_edges;
+        sw.Restart();
+        {
+            const MappedFile mapped_file(graph_file_name);
+            parse_fmi_file(mapped_file, mapped_nodes, mapped_edges, thread_count);
+        }
+        const auto mapped_time = sw.Stop();
+
+        const bool valid = equal_edges(stream_edges, mapped_single_edges) && equal_edges(stream_edges, mapped_edges)
+                           && equal_nodes(stream_nodes, mapped_single_nodes) && equal_nodes(stream_nodes, mapped_nodes);
+
+        std::stringstream stream_time_str, mapped_single_time_str, mapped_time_str;
+        stream_time_str << stream_time << "ms";
+        mapped_single_time_str << mapped_single_time << "ms";
+        mapped_time_str << mapped_time << "ms";
+        std::cout << "[BENCHMARK] Parsing "
+                  << "Stream: " << std::left << std::setw(12) << stream_time_str.str()
+                  << "Mapped (1 thread): " << std::left << std::setw(12) << mapped_single_time_str.str()
+                  << "Mapped: " << std::left << std::setw(12) << mapped_time_str.str()
+                  << " for " << stream_edges.size() << " edges" << (valid ? "" : " [Failed: graphs differ]")
+                  << std::endl;
+
+        // full graph construction
+        sw.Restart();
+        const auto stream_graph = Graph(std::fstream(graph_file_name, std::ios::in));
+        const auto stream_graph_time = sw.Stop();
+
+        sw.Restart();
+        {
+            const MappedFile mapped_file(graph_file_name);
+            const auto mapped_graph = Graph(mapped_file, thread_count);
+        }
+        const auto mapped_graph_time = sw.Stop();
+
+        std::stringstream stream_graph_time_str, mapped_graph_time_str;
+        stream_graph_time_str << stream_graph_time << "ms";
+        mapped_graph_time_str << mapped_graph_time << "ms";
+        std::cout << "[BENCHMARK] Graph   "
+                  << "Stream: " << std::left << std::setw(12) << stream_graph_time_str.str()
+                  << "Mapped: " << std::left << std::setw(12) << mapped_graph_time_str.str()
+                  << " for " << stream_graph.get_node_count() << " nodes" << std::endl;
+    }
+
+    // CSR construction as it was done before the counting sort, kept as a reference for the benchmark
+    inline void build_csr_by_sorting(std::vector<FMIEdge> &edges, const int node_count, std::vector<int> &offsets,
+                                     std::vector<Edge> &out_edges) {
+        std::sort(edges.begin(), edges.end(),
+                  [](const auto &a, const auto &b) {
+                      return a.from < b.from;
+                  });
+
+        const std::function<int(const FMIEdge &)> selector = [](const FMIEdge &edge) { return edge.from; };
+        offsets.resize(node_count + 1);
+        int last_from = -1;
+        for (int i = 0; i < edges.size(); ++i) {
+            if (const auto from = selector(edges[i]); last_from != from) {
+                for (int j = from; j > last_from; --j) {
+                    offsets[j] = i;
+                }
+                last_from = from;
+            }
+        }
+        // nodes without out edges at the end of the id range
+        for (int j = node_count; j > last_from; --j) {
+            offsets[j] = static_cast<int>(edges.size());
+        }
+
+        out_edges.resize(edges.size());
+        for (int i = 0; i < edges.size(); ++i) {
+            out_edges[i] = Edge{edges[i].to, edges[i].weight};
+        }
+    }
+
+    inline void benchmark_construction(const int edge_count) {
+        const int thread_count = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        const int node_count = std::max(1, edge_count / 4);
+        std::cout << "[BENCHMARK] Building the out edge CSR for " << edge_count << " random edges and "
+                  << node_count << " nodes with " << thread_count << " threads" << std::endl;
+
+        std::vector<FMIEdge> edges(edge_count);
+        {
+            std::mt19937 random{42};
+            std::uniform_int_distribution<int> node_distribution(0, node_count - 1);
+            std::uniform_int_distribution<int> weight_distribution(1, 1000);
+            for (auto &edge: edges) {
+                edge = FMIEdge{node_distribution(random), node_distribution(random), weight_distribution(random)};
+            }
+        }
+
+        auto sw = Stopwatch<std::chrono::milliseconds>::Start();
+
+        std::vector<int> sort_offsets;
+        std::vector<Edge> sort_edges;
+        auto edges_copy = edges;
+        sw.Restart();
+        build_csr_by_sorting(edges_copy, node_count, sort_offsets, sort_edges);
+        const auto sort_time = sw.Stop();
+
+        const auto from = [](const FMIEdge &edge) { return edge.from; };
+        const auto to_edge = [](const FMIEdge &edge) { return Edge{edge.to, edge.weight}; };
+
+        std::vector<int> single_offsets;
+        std::vector<Edge> single_edges;
+        sw.Restart();
+        build_csr(edges, node_count, single_offsets, single_edges, from, to_edge, 1);
+        const auto single_time = sw.Stop();
+
+        std::vector<int> parallel_offsets;
+        std::vector<Edge> parallel_edges;
+        sw.Restart();
+        build_csr(edges, node_count, parallel_offsets, parallel_edges, from, to_edge, thread_count);
+        const auto parallel_time = sw.Stop();
+
+        const bool valid = sort_offsets == single_offsets && sort_offsets == parallel_offsets;
+
+        std::stringstream sort_time_str, single_time_str, parallel_time_str;
+        sort_time_str << sort_time << "ms";
+        single_time_str << single_time << "ms";
+        parallel_time_str << parallel_time << "ms";
+        std::cout << "[BENCHMARK] "
+                  << "Sort: " << std::left << std::setw(12) << sort_time_str.str()
+                  << "Counting (1 thread): " << std::left << std::setw(12) << single_time_str.str()
+                  << "Counting: " << std::left << std::setw(12) << parallel_time_str.str()
+                  << (valid ? "" : " [Failed: offsets differ]") << std::endl;
+    }
+
+    /// Generates random source target pairs, the same seed gives the same queries for all benchmarks
+    inline std::vector<std::pair<int, int> > generate_random_queries(const int node_count, const int query_count) {
+        std::mt19937 random{42};
+        std::uniform_int_distribution<int> node_distribution(0, node_count - 1);
+
+        std::vector<std::pair<int, int> > queries(query_count);
+        for (auto &[source, target]: queries) {
+            source = node_distribution(random);
+            target = node_distribution(random);
+        }
+        return queries;
+    }
+
+    template<typename Queue>
+    void benchmark_queue(const Graph &graph, const std::vector<std::pair<int, int> > &queries,
+                         std::vector<int> &distances, const std::string &name) {
+        QueryWorkspace<Queue> workspace(graph.get_node_count());
+        workspace.queue.reset_statistics();
+
+        std::vector<int> results;
+        results.reserve(queries.size());
+        auto sw = Stopwatch<std::chrono::microseconds>::Start();
+        for (const auto &[source, target]: queries) {
+            results.push_back(graph.compute_shortest_path_dijkstra(source, target, workspace));
+        }
+        const auto time = sw.Stop();
+
+        // the first queue provides the reference distances
+        if (distances.empty()) {
+            distances = results;
+        }
+
+        const auto &statistics = workspace.queue.statistics();
+        const auto query_count = static_cast<long long>(std::max<size_t>(1, queries.size()));
+        std::stringstream time_str;
+        time_str << time / query_count << "us";
+        std::cout << "[BENCHMARK] " << std::left << std::setw(11) << name + ":" << std::left << std::setw(12)
+                  << time_str.str()
+                  << "Pushes: " << std::left << std::setw(12) << statistics.pushes / query_count
+                  << "Pops: " << std::left << std::setw(12) << statistics.pops / query_count
+                  << "Decrease keys: " << std::left << std::setw(12) << statistics.decrease_keys / query_count
+                  << (results == distances ? "" : " [Failed: distances differ]") << std::endl;
+    }
+
+    inline void benchmark_queues(const std::string &graph_file_name, const int query_count) {
+        const auto graph = Graph(MappedFile(graph_file_name));
+        const auto queries = generate_random_queries(graph.get_node_count(), query_count);
+        std::cout << "[BENCHMARK] Running " << query_count << " random queries per priority queue, "
+                  << "average time and queue operations per query:" << std::endl;
+
+        std::vector<int> distances;
+        benchmark_queue<BinaryHeap>(graph, queries, distances, "Binary");
+        benchmark_queue<QuaternaryHeap>(graph, queries, distances, "4-ary");
+        benchmark_queue<RadixHeap>(graph, queries, distances, "Radix");
+    }
+
+    /// Runs all queries with one point to point algorithm, prints the average time and settled nodes per query
+    /// and compares the distances with the reference, the first algorithm provides the reference
+    template<typename Algorithm>
+    void benchmark_point_to_point_algorithm(const std::vector<Query> &queries, std::vector<int> &distances,
+                                            long long &reference_time, const std::string &name,
+                                            const Algorithm &algorithm) {
+        std::vector<int> results;
+        results.reserve(queries.size());
+        long long settled_nodes = 0;
+        auto sw = Stopwatch<std::chrono::microseconds>::Start();
+        for (const auto &[source, target]: queries) {
+            int settled = 0;
+            results.push_back(algorithm(source, target, settled));
+            settled_nodes += settled;
+        }
+        const auto time = sw.Stop();
+
+        if (distances.empty()) {
+            distances = results;
+            reference_time = time;
+        }
+
+        const auto query_count = static_cast<long long>(std::max<size_t>(1, queries.size()));
+        std::stringstream time_str;
+        time_str << time / query_count << "us";
+        std::stringstream speedup_str;
+        speedup_str << std::fixed << std::setprecision(1)
+                << static_cast<double>(reference_time) / static_cast<double>(std::max(1LL, static_cast<long long>(time)))
+                << "x";
+        std::cout << "[BENCHMARK] " << std::left << std::setw(18) << name + ":" << std::left << std::setw(12)
+                  << time_str.str()
+                  << "Settled: " << std::left << std::setw(12) << settled_nodes / query_count
+                  << "Speedup: " << std::left << std::setw(8) << speedup_str.str()
+                  << (results == distances ? "" : " [Failed: distances differ]") << std::endl;
+    }
+
+    inline void benchmark_point_to_point(const std::string &graph_file_name, const std::string &query_file_name,
+                                         const int landmark_count) {
+        const auto graph = Graph(MappedFile(graph_file_name));
+        const auto queries = parse_query_file(MappedFile(query_file_name));
+
+        auto sw = Stopwatch<std::chrono::milliseconds>::Start();
+        const LandmarkIndex farthest_landmarks(graph, landmark_count, LandmarkSelection::Farthest);
+        const auto farthest_time = sw.Stop();
+        sw.Restart();
+        const LandmarkIndex avoid_landmarks(graph, landmark_count, LandmarkSelection::Avoid);
+        const auto avoid_time = sw.Stop();
+        sw.Restart();
+        const GeometricAStar geometric_a_star(graph);
+        const auto geometric_time = sw.Stop();
+        std::cout << "[BENCHMARK] Geometric A*:       " << std::setw(12) << geometric_time << " ms" << std::endl;
+        std::cout << "[BENCHMARK] Landmarks farthest: " << std::setw(12) << farthest_time << " ms" << std::endl;
+        std::cout << "[BENCHMARK] Landmarks avoid:    " << std::setw(12) << avoid_time << " ms" << std::endl;
+
+        std::cout << "[BENCHMARK] Running " << queries.size() << " queries from '" << query_file_name
+                  << "', average time and settled nodes per query:" << std::endl;
+
+        std::vector<int> distances;
+        long long reference_time = 0;
+        QueryWorkspace<> workspace(graph.get_node_count());
+        benchmark_point_to_point_algorithm(queries, distances, reference_time, "Dijkstra",
+                                           [&](const int source, const int target, int &settled) {
+                                               const auto distance = graph.compute_shortest_path_dijkstra(
+                                                   source, target, workspace);
+                                               settled = workspace.settled_nodes;
+                                               return distance;
+                                           });
+
+        BidirectionalWorkspace<> bidirectional_workspace(graph.get_node_count());
+        benchmark_point_to_point_algorithm(queries, distances, reference_time, "Bidirectional",
+                                           [&](const int source, const int target, int &settled) {
+                                               const auto distance = graph.compute_shortest_path_bidirectional(
+                                                   source, target, bidirectional_workspace);
+                                               settled = bidirectional_workspace.settled_nodes();
+                                               return distance;
+                                           });
+
+        AStarWorkspace<> a_star_workspace(graph.get_node_count());
+        benchmark_point_to_point_algorithm(queries, distances, reference_time, "A* geometric",
+                                           [&](const int source, const int target, int &settled) {
+                                               const auto distance = geometric_a_star.compute_shortest_path(
+                                                   source, target, a_star_workspace);
+                                               settled = a_star_workspace.search.settled_nodes;
+                                               return distance;
+                                           });
+        for (const auto &[name, landmarks]: {std::pair{"ALT farthest", &farthest_landmarks},
+                                            std::pair{"ALT avoid", &avoid_landmarks}}) {
+            benchmark_point_to_point_algorithm(queries, distances, reference_time, name,
+                                               [&](const int source, const int target, int &settled) {
+                                                   const auto distance = landmarks->compute_shortest_path(
+                                                       source, target, a_star_workspace);
+                                                   settled = a_star_workspace.search.settled_nodes;
+                                                   return distance;
+                                               });
+        }
+    }
+} // exercise::one
+
+#endif //BENCHMARKS_H
@@ -0,0 +1,102 @@
+//
+// Created by Jost on 17/10/2026.
+//
+
+#ifndef BUFFERED_WRITER_H
+#define BUFFERED_WRITER_H
+
+#include <charconv>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace exercise::one {
+    /// Text writer that formats into a large buffer and hands it to the file in one piece when it fills up
+    class BufferedWriter {
+    public:
+        explicit BufferedWriter(const std::string &file_name, const size_t buffer_size = 1 << 22)
+            : m_file(std::fopen(file_name.c_str(), "wb")) {
+            m_buffer.resize(buffer_size);
+            m_failed = m_file == nullptr;
+        }
+
+        ~BufferedWriter() {
+            close();
+        }
+
+        BufferedWriter(const BufferedWriter &) = delete;
+
+        BufferedWriter &operator=(const BufferedWriter &) = delete;
+
+        [[nodiscard]] bool is_open() const {
+            return m_file != nullptr;
+        }
+
+        BufferedWriter &operator<<(const std::string_view text) {
+            if (m_size + text.size() > m_buffer.size()) {
+                flush();
+            }
+            if (text.size() > m_buffer.size()) {
+                write_to_file(text.data(), text.size());
+                return *this;
+            }
+            text.copy(m_buffer.data() + m_size, text.size());
+            m_size += text.size();
+            return *this;
+        }
+
+        BufferedWriter &operator<<(const char character) {
+            if (m_size + 1 > m_buffer.size()) {
+                flush();
+            }
+            m_buffer[m_size++] = character;
+            return *this;
+        }
+
+        BufferedWriter &operator<<(const long long value) {
+            // enough for any 64 bit integer including the sign
+            constexpr size_t MAX_DIGITS = 20;
+            if (m_size + MAX_DIGITS > m_buffer.size()) {
+                flush();
+            }
+            const auto result = std::to_chars(m_buffer.data() + m_size, m_buffer.data() + m_buffer.size(), value);
+            m_size = result.ptr - m_buffer.data();
+            return *this;
+        }
+
+        BufferedWriter &operator<<(const int value) {
+            return *this << static_cast<long long>(value);
+        }
+
+        void flush() {
+            write_to_file(m_buffer.data(), m_size);
+            m_size = 0;
+        }
+
+        /// Flushes the remaining buffer, returns false if any write failed
+        bool close() {
+            if (m_file == nullptr)
+                return !m_failed;
+
+            flush();
+            m_failed |= std::fclose(m_file) != 0;
+            m_file = nullptr;
+            return !m_failed;
+        }
+
+    private:
+        std::FILE *m_file;
+        std::vector<char> m_buffer;
+        size_t m_size = 0;
+        bool m_failed = false;
+
+        void write_to_file(const char *data, const size_t size) {
+            if (m_file == nullptr || size == 0)
+                return;
+            m_failed |= std::fwrite(data, 1, size, m_file) != size;
+        }
+    };
+} // exercise::one
+
+#endif //BUFFERED_WRITER_H
@@ -0,0 +1,131 @@
+//
+// Created by Jost on 17/10/2026.
+//
+
+#include "geometric_a_star.h"
+
+#include <limits>
+#include <mutex>
+
+#include "csr_builder.h"
+#include "priority_queues.h"
+
+namespace exercise::one {
+    constexpr double EARTH_RADIUS_METERS = 6'371'000;
+    constexpr double DEGREES_TO_RADIANS = 3.14159265358979323846 / 180;
+    // the bound is only guaranteed up to rounding errors, shrinking it a little keeps it below the real distance
+    constexpr double LOWER_BOUND_SAFETY_FACTOR = 1 - 1e-6;
+
+    GeometricAStar::GeometricAStar(const Graph &graph, const int thread_count) : m_graph(&graph) {
+        const auto node_count = graph.get_node_count();
+        const auto &latitudes = graph.get_latitudes();
+        const auto &longitudes = graph.get_longitudes();
+
+        // the trigonometry is done once per node
+        m_x.resize(node_count);
+        m_y.resize(node_count);
+        m_z.resize(node_count);
+        parallel_for_chunks(node_count, thread_count, [&](const size_t begin, const size_t end) {
+            for (auto i = begin; i < end; ++i) {
+                const auto latitude = latitudes[i] * DEGREES_TO_RADIANS;
+                const auto longitude = longitudes[i] * DEGREES_TO_RADIANS;
+                m_x[i] = std::cos(latitude) * std::cos(longitude);
+                m_y[i] = std::cos(latitude) * std::sin(longitude);
+                m_z[i] = std::sin(latitude);
+            }
+        });
+
+        // edges between nodes at the same position don't restrict the scale
+        std::mutex mutex;
+        auto weight_per_chord = std::numeric_limits<double>::infinity();
+        parallel_for_chunks(node_count, thread_count, [&](const size_t begin, const size_t end) {
+            auto chunk_weight_per_chord = std::numeric_limits<double>::infinity();
+            for (auto from = begin; from < end; ++from) {
+                for (const auto [to, weight]: graph.get_out_edges(static_cast<int>(from))) {
+                    const auto dx = m_x[from] - m_x[to];
+                    const auto dy = m_y[from] - m_y[to];
+                    const auto dz = m_z[from] - m_z[to];
+                    if (const auto chord = std::sqrt(dx * dx + dy * dy + dz * dz); chord > 0) {
+                        chunk_weight_per_chord = std::min(chunk_weight_per_chord, weight / chord);
+                    }
+                }
+            }
+
+            const std::lock_guard lock(mutex);
+            weight_per_chord = std::min(weight_per_chord, chunk_weight_per_chord);
+        });
+
+        // without any usable edge the search falls back to Dijkstra
+        if (weight_per_chord == std::numeric_limits<double>::infinity()) {
+            weight_per_chord = 0;
+        }
+        m_weight_per_meter = weight_per_chord / EARTH_RADIUS_METERS;
+        m_weight_per_chord = weight_per_chord * LOWER_BOUND_SAFETY_FACTOR;
+    }
+
+    int GeometricAStar::compute_shortest_path(const int source, const int target) const {
+        thread_local AStarWorkspace<> workspace;
+        return compute_shortest_path(source, target, workspace);
+    }
+
+    template<typename Queue>
+    int GeometricAStar::compute_shortest_path(const int source, const int target,
+                                              AStarWorkspace<Queue> &workspace) const {
+        workspace.reset(m_graph->get_node_count());
+        if (!m_graph->may_be_connected(source, target))
+            return -1;
+
+        auto &distances = workspace.search.distances;
+        auto &queue = workspace.search.queue;
+        auto &potentials = workspace.potentials;
+
+        const auto source_potential = compute_lower_bound(source, target);
+        distances.set(source, 0);
+        potentials.set(source, source_potential);
+        queue.push(source, source_potential);
+
+        while (!queue.empty()) {
+            const auto [index, key] = queue.pop();
+            const auto distance = distances.get(index);
+
+            // the key was pushed with an older, longer distance
+            if (key - potentials.get(index) > distance) {
+                continue;
+            }
+            workspace.search.settled_nodes++;
+
+            if (index == target) {
+                break;
+            }
+
+            for (const auto [neighbour_index, weight]: m_graph->get_out_edges(index)) {
+                const auto new_distance = distance + weight;
+                if (new_distance >= distances.get(neighbour_index)) {
+                    continue;
+                }
+
+                auto potential = potentials.get(neighbour_index);
+                if (potential == TimestampedDistances::INFINITE_DISTANCE) {
+                    potential = compute_lower_bound(neighbour_index, target);
+                    potentials.set(neighbour_index, potential);
+                }
+
+                distances.set(neighbour_index, new_distance);
+                queue.push(neighbour_index, new_distance + potential);
+            }
+        }
+
+        if (distances.get(target) == TimestampedDistances::INFINITE_DISTANCE)
+            return -1;
+
+        return distances.get(target);
+    }
+
+    template int GeometricAStar::compute_shortest_path(int, int, AStarWorkspace<BinaryHeap> &) const;
+    template int GeometricAStar::compute_shortest_path(int, int, AStarWorkspace<QuaternaryHeap> &) const;
+    template int GeometricAStar::compute_shortest_path(int, int, AStarWorkspace<RadixHeap> &) const;
+
+    double GeometricAStar::get_weight_per_meter() const {
+        return m_weight_per_meter;
+    }
+} // exercise::one
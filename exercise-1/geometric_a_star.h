@@ -0,0 +1,58 @@
+//
+// Created by Jost on 17/10/2026.
+//
+
+#ifndef GEOMETRIC_A_STAR_H
+#define GEOMETRIC_A_STAR_H
+
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#include "graph.h"
+#include "query_workspace.h"
+
+namespace exercise::one {
+    /// A* search guided by the straight-line distance to the target.
+    ///
+    /// The haversine formula d = 2R * asin(sqrt(a)) needs trigonometry per evaluation, but with the nodes as unit
+    /// vectors a = |p - q|^2 / 4, and as asin(x) >= x the chord length R * |p - q| is a lower bound of the
+    /// great-circle distance that only needs multiplications, additions and one square root. The chord also obeys
+    /// the triangle inequality, so scaled with the smallest weight per meter of any edge (1 / maximum speed for
+    /// travel time weights) it is a consistent potential.
+    class GeometricAStar {
+    public:
+        explicit GeometricAStar(const Graph &graph,
+                                int thread_count = static_cast<int>(std::thread::hardware_concurrency()));
+
+        [[nodiscard]] int compute_shortest_path(int source, int target) const;
+        /// Instantiated for the BinaryHeap, QuaternaryHeap and RadixHeap queues
+        template<typename Queue>
+        [[nodiscard]] int compute_shortest_path(int source, int target, AStarWorkspace<Queue> &workspace) const;
+
+        /// Lower bound of the distance from node to target
+        [[nodiscard]] int compute_lower_bound(const int node, const int target) const {
+            const auto dx = m_x[node] - m_x[target];
+            const auto dy = m_y[node] - m_y[target];
+            const auto dz = m_z[node] - m_z[target];
+            return static_cast<int>(std::sqrt(dx * dx + dy * dy + dz * dz) * m_weight_per_chord);
+        }
+
+        /// Smallest weight per meter of straight-line distance over all edges
+        [[nodiscard]] double get_weight_per_meter() const;
+
+    private:
+        const Graph *m_graph;
+
+        // unit vectors of the nodes, double precision because nearby nodes differ only in the last float digits
+        std::vector<double> m_x;
+        std::vector<double> m_y;
+        std::vector<double> m_z;
+
+        double m_weight_per_meter = 0;
+        // converts a chord of the unit sphere into a weight, slightly rounded down against floating point errors
+        double m_weight_per_chord = 0;
+    };
+} // exercise::one
+
+#endif //GEOMETRIC_A_STAR_H
@@ -5,202 +5,240 @@
 #include "graph.h"
 
 #include <algorithm>
-#include <charconv>
-#include <functional>
-#include <limits>
-#include <queue>
-#include <string>
+
+#include "csr_builder.h"
+#include "snapshot.h"
+#include "union_find.h"
 
 namespace exercise::one {
-    enum READ_STATE {
-        META,
-        NODE_COUNT,
-        EDGE_COUNT,
-        NODES,
-        EDGES,
-        FINISHED
-    };
-
-    struct FMIEdge {
-        int from, to;
-        int weight;
-    };
-
-    static FMIEdge parse_edge(const std::string_view line) {
-        const auto from_end = line.find(' ');
-        const auto to_start = from_end + 1;
-        const auto to_end = line.find(' ', to_start);
-        const auto weight_start = to_end + 1;
-        const auto weight_end = line.find(' ', weight_start);
-
-        int from, to, weight;
-        std::from_chars(line.data(), line.data() + from_end, from);
-        std::from_chars(line.data() + to_start, line.data() + to_end, to);
-        std::from_chars(line.data() + weight_start, line.data() + weight_end, weight);
-
-        return FMIEdge{from, to, weight};
-    }
-
-    static int parse_file(std::fstream input_file, std::vector<FMIEdge> &edges) {
-        int node_count = 0;
-
-        auto state = READ_STATE::META;
-        int node_index = 0;
-        int edge_index = 0;
-
-        std::string line;
-        while (std::getline(input_file, line)) {
-            switch (state) {
-                case READ_STATE::META:
-                    // metadata section ends with an empty line
-                    if (line.empty()) {
-                        state = READ_STATE::NODE_COUNT;
-                    }
-                    break;
-
-                case READ_STATE::NODE_COUNT:
-                    node_count = std::stoi(line);
-                    state = READ_STATE::EDGE_COUNT;
-                    break;
-
-                case READ_STATE::EDGE_COUNT:
-                    edges.resize(std::stoi(line));
-                    state = READ_STATE::NODES;
-                    break;
-
-                case READ_STATE::NODES:
-                    // skip parsing nodes
-                    node_index++;
-                    if (node_index >= node_count) {
-                        state = READ_STATE::EDGES;
-                    }
-                    break;
+    Graph::Graph(std::fstream input_file) {
+        FMINodes nodes;
+        std::vector<FMIEdge> edges;
+        m_node_count = parse_fmi_file(std::move(input_file), nodes, edges);
+        m_latitudes = std::move(nodes.latitudes);
+        m_longitudes = std::move(nodes.longitudes);
+        build_adjacency_arrays(edges, static_cast<int>(std::thread::hardware_concurrency()));
+    }
 
-                case READ_STATE::EDGES:
-                    edges[edge_index] = parse_edge(line);
-                    edge_index++;
-                    if (edge_index >= edges.size()) {
-                        state = READ_STATE::FINISHED;
-                    }
-                    break;
+    Graph::Graph(const MappedFile &input_file, const int thread_count) {
+        FMINodes nodes;
+        std::vector<FMIEdge> edges;
+        m_node_count = parse_fmi_file(input_file, nodes, edges, thread_count);
+        m_latitudes = std::move(nodes.latitudes);
+        m_longitudes = std::move(nodes.longitudes);
+        build_adjacency_arrays(edges, thread_count);
+    }
 
-                case READ_STATE::FINISHED:
-                    break;
-            }
-        }
-        input_file.close();
+    void Graph::build_adjacency_arrays(const std::vector<FMIEdge> &edges, const int thread_count) {
+        build_csr(edges, m_node_count, m_out_edges_offsets, m_out_edges,
+                  [](const FMIEdge &edge) { return edge.from; },
+                  [](const FMIEdge &edge) { return Edge{edge.to, edge.weight}; },
+                  thread_count);
 
-        return node_count;
+        build_csr(edges, m_node_count, m_in_edges_offsets, m_in_edges,
+                  [](const FMIEdge &edge) { return edge.to; },
+                  [](const FMIEdge &edge) { return Edge{edge.from, edge.weight}; },
+                  thread_count);
     }
 
-    static void calculate_offset_array(const std::vector<FMIEdge> &edges, std::vector<int> &offsets,
-                                       const int node_count, const std::function<int(const FMIEdge &)> &selector) {
-        offsets.resize(node_count + 1);
-        int last_from = -1;
-        for (int i = 0; i < edges.size(); ++i) {
-            if (const auto from = selector(edges[i]); last_from != from) {
-                for (int j = from; j > last_from; --j) {
-                    offsets[j] = i;
-                }
-                last_from = from;
-            }
-        }
-        offsets[node_count] = static_cast<int>(edges.size());
+    constexpr char GRAPH_SNAPSHOT_MAGIC[8] = {'F', 'M', 'I', 'G', 'R', 'A', 'P', 'H'};
+    // increase whenever the stored arrays change
+    constexpr uint32_t GRAPH_SNAPSHOT_VERSION = 2;
+
+    bool Graph::save(const std::string &file_name) const {
+        SnapshotWriter writer(file_name, GRAPH_SNAPSHOT_MAGIC, GRAPH_SNAPSHOT_VERSION);
+        writer.write_array(std::vector<int>{m_node_count});
+        writer.write_array(m_out_edges);
+        writer.write_array(m_out_edges_offsets);
+        writer.write_array(m_in_edges);
+        writer.write_array(m_in_edges_offsets);
+        writer.write_array(m_latitudes);
+        writer.write_array(m_longitudes);
+        return writer.finish();
     }
 
-    Graph::Graph(std::fstream input_file) {
-        std::vector<FMIEdge> edges;
-        m_node_count = parse_file(std::move(input_file), edges);
-
-        std::sort(edges.begin(), edges.end(),
-                  [](const auto &a, const auto &b) {
-                      return a.from < b.from;
-                  });
-        calculate_offset_array(edges, m_out_edges_offsets, m_node_count, [&](const auto &edge) { return edge.from; });
-
-        m_out_edges.resize(edges.size());
-        for (int i = 0; i < edges.size(); ++i) {
-            const auto [_, to, weight] = edges[i];
-            m_out_edges[i] = Edge{to, weight};
+    std::optional<Graph> Graph::from_snapshot(const std::string &file_name) {
+        SnapshotReader reader(file_name, GRAPH_SNAPSHOT_MAGIC, GRAPH_SNAPSHOT_VERSION);
+
+        Graph graph;
+        std::vector<int> meta;
+        if (!reader.read_array(meta) || meta.size() != 1
+            || !reader.read_array(graph.m_out_edges) || !reader.read_array(graph.m_out_edges_offsets)
+            || !reader.read_array(graph.m_in_edges) || !reader.read_array(graph.m_in_edges_offsets)
+            || !reader.read_array(graph.m_latitudes) || !reader.read_array(graph.m_longitudes)) {
+            return std::nullopt;
         }
+        graph.m_node_count = meta[0];
+
+        return graph;
+    }
+
+    int Graph::compute_weakly_connected_components(const int thread_count) {
+        // every in edge is also an out edge, so uniting along the out edges is enough
+        ConcurrentUnionFind sets(m_node_count);
+        parallel_for_chunks(m_node_count, thread_count, [this, &sets](const size_t begin, const size_t end) {
+            for (auto node = static_cast<int>(begin); node < static_cast<int>(end); ++node) {
+                for (const auto &edge: get_out_edges(node)) {
+                    sets.unite(node, edge.to);
+                }
+            }
+        });
 
-        std::sort(edges.begin(), edges.end(),
-                  [](const auto &a, const auto &b) {
-                      return a.to < b.to;
-                  });
-        calculate_offset_array(edges, m_in_edges_offsets, m_node_count, [&](const auto &edge) { return edge.to; });
+        m_node_components.resize(m_node_count);
+        parallel_for_chunks(m_node_count, thread_count, [this, &sets](const size_t begin, const size_t end) {
+            for (auto node = static_cast<int>(begin); node < static_cast<int>(end); ++node) {
+                m_node_components[node] = sets.find(node);
+            }
+        });
 
-        m_in_edges.resize(edges.size());
-        for (int i = 0; i < edges.size(); ++i) {
-            const auto [from, _, weight] = edges[i];
-            m_in_edges[i] = Edge{from, weight};
+        // the root of a component is its smallest node, so it is numbered before any other node points to it
+        int component_count = 0;
+        for (int node = 0; node < m_node_count; ++node) {
+            const auto root = m_node_components[node];
+            m_node_components[node] = root == node ? component_count++ : m_node_components[root];
         }
+
+        return component_count;
     }
 
-    int Graph::compute_weakly_connected_components() const {
-        int component_count = 0;
-        std::vector<int> node_components;
-        node_components.resize(m_node_count, -1);
+    int Graph::compute_strongly_connected_components(std::vector<int> &node_components) const {
+        constexpr int UNVISITED = -1;
+
+        // a frame of the depth first search is a node and the position of its next out edge
+        struct Frame {
+            int node;
+            int next_edge;
+        };
 
+        std::vector<int> indices(m_node_count, UNVISITED);
+        std::vector<int> low_links(m_node_count);
+        std::vector<char> on_stack(m_node_count, false);
         std::vector<int> stack;
-        stack.resize(m_out_edges.size() * 2);
-        int stack_top = -1;
+        std::vector<Frame> frames;
+        node_components.assign(m_node_count, -1);
 
-        int component_index = 0;
-        for (int i = 0; i < m_node_count; ++i) {
-            if (node_components[i] != -1) {
+        int index = 0;
+        int component_count = 0;
+        const auto visit = [&](const int node) {
+            indices[node] = low_links[node] = index++;
+            stack.push_back(node);
+            on_stack[node] = true;
+            frames.push_back(Frame{node, m_out_edges_offsets[node]});
+        };
+
+        for (int root = 0; root < m_node_count; ++root) {
+            if (indices[root] != UNVISITED) {
                 continue;
             }
 
-            stack[++stack_top] = i;
-            while (stack_top >= 0) {
-                const auto node = stack[stack_top--];
-
-                if (node_components[node] != -1) {
+            visit(root);
+            while (!frames.empty()) {
+                const auto node = frames.back().node;
+                if (frames.back().next_edge < m_out_edges_offsets[node + 1]) {
+                    const auto neighbour = m_out_edges[frames.back().next_edge++].to;
+                    if (indices[neighbour] == UNVISITED) {
+                        visit(neighbour);
+                    } else if (on_stack[neighbour]) {
+                        low_links[node] = std::min(low_links[node], indices[neighbour]);
+                    }
                     continue;
                 }
 
-                node_components[node] = component_index;
-
-                for (int j = m_out_edges_offsets[node]; j < m_out_edges_offsets[node + 1]; ++j) {
-                    stack[++stack_top] = m_out_edges[j].to;
+                // all edges done, the node is the root of a component if nothing below reaches further up
+                frames.pop_back();
+                if (low_links[node] == indices[node]) {
+                    int member;
+                    do {
+                        member = stack.back();
+                        stack.pop_back();
+                        on_stack[member] = false;
+                        node_components[member] = component_count;
+                    } while (member != node);
+                    component_count++;
                 }
-                for (int j = m_in_edges_offsets[node]; j < m_in_edges_offsets[node + 1]; ++j) {
-                    stack[++stack_top] = m_in_edges[j].to;
+                if (!frames.empty()) {
+                    const auto parent = frames.back().node;
+                    low_links[parent] = std::min(low_links[parent], low_links[node]);
                 }
             }
-            component_count++;
-            component_index++;
         }
 
         return component_count;
     }
 
+    Graph Graph::extract_largest_strongly_connected_component(std::vector<int> &node_index_map,
+                                                             const int thread_count) const {
+        std::vector<int> node_components;
+        const auto component_count = compute_strongly_connected_components(node_components);
+
+        std::vector<int> component_sizes(component_count, 0);
+        for (const auto component: node_components) {
+            component_sizes[component]++;
+        }
+        const auto largest_component = static_cast<int>(
+            std::max_element(component_sizes.begin(), component_sizes.end()) - component_sizes.begin());
+
+        Graph graph;
+        node_index_map.assign(m_node_count, -1);
+        for (int node = 0; node < m_node_count; ++node) {
+            if (node_components[node] == largest_component) {
+                node_index_map[node] = graph.m_node_count++;
+                graph.m_latitudes.push_back(m_latitudes[node]);
+                graph.m_longitudes.push_back(m_longitudes[node]);
+            }
+        }
+
+        // an edge leaving the component can't be part of a path inside it
+        std::vector<FMIEdge> edges;
+        for (int node = 0; node < m_node_count; ++node) {
+            const auto from = node_index_map[node];
+            if (from == -1) {
+                continue;
+            }
+            for (const auto [to, weight]: get_out_edges(node)) {
+                if (node_index_map[to] != -1) {
+                    edges.push_back(FMIEdge{from, node_index_map[to], weight});
+                }
+            }
+        }
+        graph.build_adjacency_arrays(edges, thread_count);
+
+        return graph;
+    }
+
+    int Graph::get_component(const int node) const {
+        return m_node_components.empty() ? -1 : m_node_components[node];
+    }
+
     int Graph::compute_shortest_path_dijkstra(const int source, const int target) const {
-        struct SPNode {
-            int index;
-            int distance;
-        };
+        // every thread keeps one workspace, so repeated queries don't allocate and clear the distance array
+        thread_local QueryWorkspace<> workspace;
+        return compute_shortest_path_dijkstra(source, target, workspace);
+    }
 
-        std::vector<int> distances;
-        distances.resize(m_node_count, std::numeric_limits<int>::max());
+    template<typename Queue>
+    int Graph::compute_shortest_path_dijkstra(const int source, const int target,
+                                              QueryWorkspace<Queue> &workspace) const {
+        workspace.reset(m_node_count);
+        if (!may_be_connected(source, target))
+            return -1;
 
-        // creates a min priority queue ordered by distance
-        auto cmp = [](const SPNode &left, const SPNode &right) { return left.distance > right.distance; };
-        std::priority_queue<SPNode, std::vector<SPNode>, decltype(cmp)> queue(cmp);
+        auto &distances = workspace.distances;
+        auto &queue = workspace.queue;
 
-        distances[source] = 0;
-        queue.push(SPNode{source, 0});
+        distances.set(source, 0);
+        queue.push(source, 0);
 
         while (!queue.empty()) {
-            const auto [index, distance] = queue.top();
-            queue.pop();
+            const auto [index, distance] = queue.pop();
 
             // old invalid entry, not removed for performance
-            if (distance > distances[index]) {
+            if (distance > distances.get(index)) {
                 continue;
             }
 
+            workspace.settled_nodes++;
+
             // target node expanded, shortest path found
             if (index == target) {
                 break;
@@ -208,21 +246,101 @@ namespace exercise::one {
 
             for (int i = m_out_edges_offsets[index]; i < m_out_edges_offsets[index + 1]; ++i) {
                 const auto [neighbour_index, weight] = m_out_edges[i];
-                if (const auto new_distance = distance + weight; new_distance < distances[neighbour_index]) {
-                    distances[neighbour_index] = new_distance;
-                    queue.push(SPNode{neighbour_index, new_distance});
+                if (const auto new_distance = distance + weight; new_distance < distances.get(neighbour_index)) {
+                    distances.set(neighbour_index, new_distance);
+                    queue.push(neighbour_index, new_distance);
                 }
             }
         }
 
         // no path exists return an invalid distance
-        if (distances[target] == std::numeric_limits<int>::max())
+        if (distances.get(target) == TimestampedDistances::INFINITE_DISTANCE)
             return -1;
 
-        return distances[target];
+        return distances.get(target);
+    }
+
+    template int Graph::compute_shortest_path_dijkstra(int, int, QueryWorkspace<BinaryHeap> &) const;
+    template int Graph::compute_shortest_path_dijkstra(int, int, QueryWorkspace<QuaternaryHeap> &) const;
+    template int Graph::compute_shortest_path_dijkstra(int, int, QueryWorkspace<RadixHeap> &) const;
+
+    int Graph::compute_shortest_path_bidirectional(const int source, const int target) const {
+        thread_local BidirectionalWorkspace<> workspace;
+        return compute_shortest_path_bidirectional(source, target, workspace);
     }
 
+    template<typename Queue>
+    int Graph::compute_shortest_path_bidirectional(const int source, const int target,
+                                                   BidirectionalWorkspace<Queue> &workspace) const {
+        workspace.reset(m_node_count);
+        if (source == target)
+            return 0;
+        if (!may_be_connected(source, target))
+            return -1;
+
+        auto &forward = workspace.forward;
+        auto &backward = workspace.backward;
+        forward.distances.set(source, 0);
+        forward.queue.push(source, 0);
+        backward.distances.set(target, 0);
+        backward.queue.push(target, 0);
+
+        // length of the shortest path over a node reached by both searches
+        long long best_distance = TimestampedDistances::INFINITE_DISTANCE;
+        // distance of the last node settled by each search, all unsettled nodes are at least this far away
+        long long forward_radius = 0;
+        long long backward_radius = 0;
+
+        // once one search ran out of nodes, every path it could find was already seen by the relaxations
+        while (!forward.queue.empty() && !backward.queue.empty()) {
+            const auto expand_forward = forward_radius <= backward_radius;
+            auto &search = expand_forward ? forward : backward;
+            const auto &other = expand_forward ? backward : forward;
+
+            const auto [index, distance] = search.queue.pop();
+            if (distance > search.distances.get(index)) {
+                continue;
+            }
+
+            (expand_forward ? forward_radius : backward_radius) = distance;
+            if (forward_radius + backward_radius >= best_distance) {
+                break;
+            }
+            search.settled_nodes++;
+
+            for (const auto [neighbour_index, weight]: expand_forward ? get_out_edges(index) : get_in_edges(index)) {
+                const auto new_distance = distance + weight;
+                if (new_distance < search.distances.get(neighbour_index)) {
+                    search.distances.set(neighbour_index, new_distance);
+                    search.queue.push(neighbour_index, new_distance);
+                }
+
+                if (const auto other_distance = other.distances.get(neighbour_index);
+                    other_distance != TimestampedDistances::INFINITE_DISTANCE) {
+                    best_distance = std::min(best_distance, static_cast<long long>(new_distance) + other_distance);
+                }
+            }
+        }
+
+        if (best_distance == TimestampedDistances::INFINITE_DISTANCE)
+            return -1;
+
+        return static_cast<int>(best_distance);
+    }
+
+    template int Graph::compute_shortest_path_bidirectional(int, int, BidirectionalWorkspace<BinaryHeap> &) const;
+    template int Graph::compute_shortest_path_bidirectional(int, int, BidirectionalWorkspace<QuaternaryHeap> &) const;
+    template int Graph::compute_shortest_path_bidirectional(int, int, BidirectionalWorkspace<RadixHeap> &) const;
+
     int Graph::get_node_count() const {
         return m_node_count;
     }
+
+    const std::vector<float> &Graph::get_latitudes() const {
+        return m_latitudes;
+    }
+
+    const std::vector<float> &Graph::get_longitudes() const {
+        return m_longitudes;
+    }
 } // exercise::one
@@ -6,30 +6,112 @@
 #define GRAPH_H
 
 #include <fstream>
+#include <optional>
+#include <string>
+#include <thread>
 #include <vector>
 
+#include "mapped_file.h"
+#include "parse_fmi_file.h"
+#include "query_workspace.h"
+
 namespace exercise::one {
     struct Edge {
         int to;
         int weight;
     };
 
+    /// The edges of one node, a view into the adjacency array
+    struct EdgeRange {
+        const Edge *first;
+        const Edge *last;
+
+        [[nodiscard]] const Edge *begin() const {
+            return first;
+        }
+
+        [[nodiscard]] const Edge *end() const {
+            return last;
+        }
+    };
+
     class Graph {
     public:
         explicit Graph(std::fstream input_file);
 
-        [[nodiscard]] int compute_weakly_connected_components() const;
+        explicit Graph(const MappedFile &input_file,
+                       int thread_count = static_cast<int>(std::thread::hardware_concurrency()));
+
+        /// Writes the adjacency arrays into a binary snapshot, that can be loaded again without parsing or sorting
+        [[nodiscard]] bool save(const std::string &file_name) const;
+
+        /// Loads a graph written by save(), returns nothing if the file is missing, outdated or corrupted
+        static std::optional<Graph> from_snapshot(const std::string &file_name);
+
+        /// Labels every node with the id of its weakly connected component and returns the amount of components.
+        /// Afterward the queries answer pairs of nodes in different components with -1 without searching
+        int compute_weakly_connected_components(
+            int thread_count = static_cast<int>(std::thread::hardware_concurrency()));
+        /// Id of the weakly connected component of the node, -1 if the components weren't computed
+        [[nodiscard]] int get_component(int node) const;
+        /// Labels every node with the id of its strongly connected component (iterative Tarjan),
+        /// returns the amount of components
+        int compute_strongly_connected_components(std::vector<int> &node_components) const;
+        /// Subgraph of the largest strongly connected component with the nodes numbered from 0 in their old order.
+        /// node_index_map maps every old node to its new index, -1 for nodes that were dropped
+        [[nodiscard]] Graph extract_largest_strongly_connected_component(
+            std::vector<int> &node_index_map,
+            int thread_count = static_cast<int>(std::thread::hardware_concurrency())) const;
+        /// False only if both nodes are known to be in different weakly connected components
+        [[nodiscard]] bool may_be_connected(const int source, const int target) const {
+            return m_node_components.empty() || m_node_components[source] == m_node_components[target];
+        }
         [[nodiscard]] int compute_shortest_path_dijkstra(int source, int target) const;
+        /// Same query, but all memory is taken from the given workspace, so it runs in O(touched nodes).
+        /// Instantiated for the BinaryHeap, QuaternaryHeap and RadixHeap queues
+        template<typename Queue>
+        [[nodiscard]] int compute_shortest_path_dijkstra(int source, int target,
+                                                         QueryWorkspace<Queue> &workspace) const;
+        /// Dijkstra from both ends, the search with the smaller radius is expanded next and both stop
+        /// as soon as the radii add up to the shortest path found where they met
+        [[nodiscard]] int compute_shortest_path_bidirectional(int source, int target) const;
+        template<typename Queue>
+        [[nodiscard]] int compute_shortest_path_bidirectional(int source, int target,
+                                                              BidirectionalWorkspace<Queue> &workspace) const;
         [[nodiscard]] int get_node_count() const;
 
+        /// Coordinates of the nodes in degrees, 0 for nodes the file didn't list
+        [[nodiscard]] const std::vector<float> &get_latitudes() const;
+        [[nodiscard]] const std::vector<float> &get_longitudes() const;
+
+        [[nodiscard]] EdgeRange get_out_edges(const int node) const {
+            return EdgeRange{m_out_edges.data() + m_out_edges_offsets[node],
+                             m_out_edges.data() + m_out_edges_offsets[node + 1]};
+        }
+
+        [[nodiscard]] EdgeRange get_in_edges(const int node) const {
+            return EdgeRange{m_in_edges.data() + m_in_edges_offsets[node],
+                             m_in_edges.data() + m_in_edges_offsets[node + 1]};
+        }
+
     private:
-        int m_node_count;
+        int m_node_count{};
+
+        std::vector<float> m_latitudes;
+        std::vector<float> m_longitudes;
+
+        // empty until the weakly connected components are computed
+        std::vector<int> m_node_components;
 
         std::vector<Edge> m_out_edges;
         std::vector<int> m_out_edges_offsets;
 
         std::vector<Edge> m_in_edges;
         std::vector<int> m_in_edges_offsets;
+
+        Graph() = default;
+
+        void build_adjacency_arrays(const std::vector<FMIEdge> &edges, int thread_count);
     };
 } // exercise::one
 
@@ -0,0 +1,320 @@
+//
+// Created by Jost on 17/10/2026.
+//
+
+#include "landmarks.h"
+
+#include <algorithm>
+#include <random>
+
+#include "csr_builder.h"
+#include "priority_queues.h"
+
+namespace exercise::one {
+    constexpr int INFINITE_DISTANCE = TimestampedDistances::INFINITE_DISTANCE;
+    // the landmark selection is randomized, but should give the same landmarks for the same graph
+    constexpr unsigned LANDMARK_SEED = 42;
+
+    /// Dijkstra from source to all nodes, over the in edges it computes the distances to the source instead.
+    /// Optionally records the parent of every node in the shortest path tree and the order in which they were settled
+    static void compute_distances(const Graph &graph, const int source, const bool over_in_edges,
+                                  std::vector<int> &distances, std::vector<int> *parents = nullptr,
+                                  std::vector<int> *settle_order = nullptr) {
+        distances.assign(graph.get_node_count(), INFINITE_DISTANCE);
+        if (parents != nullptr) {
+            parents->assign(graph.get_node_count(), -1);
+        }
+        if (settle_order != nullptr) {
+            settle_order->clear();
+        }
+
+        BinaryHeap queue;
+        distances[source] = 0;
+        queue.push(source, 0);
+        while (!queue.empty()) {
+            const auto [index, distance] = queue.pop();
+            if (distance > distances[index]) {
+                continue;
+            }
+            if (settle_order != nullptr) {
+                settle_order->push_back(index);
+            }
+
+            for (const auto [neighbour_index, weight]: over_in_edges
+                                                           ? graph.get_in_edges(index)
+                                                           : graph.get_out_edges(index)) {
+                if (const auto new_distance = distance + weight; new_distance < distances[neighbour_index]) {
+                    distances[neighbour_index] = new_distance;
+                    queue.push(neighbour_index, new_distance);
+                    if (parents != nullptr) {
+                        (*parents)[neighbour_index] = index;
+                    }
+                }
+            }
+        }
+    }
+
+    /// Node with the largest finite distance, if no node is farther away than 0 the first unreachable one
+    /// so the landmarks spread over all components. -1 if all nodes have distance 0
+    static int find_farthest_node(const std::vector<int> &distances) {
+        int farthest_node = -1;
+        int unreachable_node = -1;
+        for (int i = 0; i < static_cast<int>(distances.size()); ++i) {
+            if (distances[i] == INFINITE_DISTANCE) {
+                if (unreachable_node == -1) {
+                    unreachable_node = i;
+                }
+            } else if (distances[i] > 0 && (farthest_node == -1 || distances[i] > distances[farthest_node])) {
+                farthest_node = i;
+            }
+        }
+        return farthest_node != -1 ? farthest_node : unreachable_node;
+    }
+
+    static std::vector<int> select_farthest_landmarks(const Graph &graph, const int landmark_count,
+                                                      std::vector<std::vector<int> > &from_tables) {
+        std::mt19937 generator(LANDMARK_SEED);
+        const auto start = std::uniform_int_distribution(0, graph.get_node_count() - 1)(generator);
+
+        std::vector<int> distances;
+        compute_distances(graph, start, false, distances);
+        auto next_landmark = find_farthest_node(distances);
+        if (next_landmark == -1) {
+            next_landmark = start;
+        }
+
+        // distance from the closest landmark to every node
+        std::vector<int> landmark_distances(graph.get_node_count(), INFINITE_DISTANCE);
+        std::vector<int> landmarks;
+        while (static_cast<int>(landmarks.size()) < landmark_count && next_landmark != -1) {
+            auto &from_table = from_tables[landmarks.size()];
+            landmarks.push_back(next_landmark);
+
+            compute_distances(graph, next_landmark, false, from_table);
+            for (int i = 0; i < graph.get_node_count(); ++i) {
+                landmark_distances[i] = std::min(landmark_distances[i], from_table[i]);
+            }
+            next_landmark = find_farthest_node(landmark_distances);
+        }
+
+        return landmarks;
+    }
+
+    static std::vector<int> select_avoid_landmarks(const Graph &graph, const int landmark_count,
+                                                   std::vector<std::vector<int> > &from_tables,
+                                                   std::vector<std::vector<int> > &to_tables) {
+        const auto node_count = graph.get_node_count();
+        std::mt19937 generator(LANDMARK_SEED);
+        std::uniform_int_distribution random_node(0, node_count - 1);
+
+        std::vector<int> landmarks;
+        std::vector<char> is_landmark(node_count, false);
+        std::vector<int> distances;
+        std::vector<int> parents;
+        std::vector<int> settle_order;
+        std::vector<long long> sizes(node_count);
+        std::vector<int> best_children(node_count);
+        std::vector<char> covered(node_count);
+
+        while (static_cast<int>(landmarks.size()) < landmark_count) {
+            const auto root = random_node(generator);
+            compute_distances(graph, root, false, distances, &parents, &settle_order);
+
+            // the size of a node sums up how badly the landmarks estimate the distances from the root over its
+            // subtree, subtrees that already contain a landmark are considered covered
+            std::fill(sizes.begin(), sizes.end(), 0);
+            std::fill(best_children.begin(), best_children.end(), -1);
+            std::fill(covered.begin(), covered.end(), false);
+            for (auto it = settle_order.rbegin(); it != settle_order.rend(); ++it) {
+                const auto node = *it;
+                covered[node] |= is_landmark[node];
+                if (covered[node]) {
+                    sizes[node] = 0;
+                } else {
+                    long long lower_bound = 0;
+                    for (size_t i = 0; i < landmarks.size(); ++i) {
+                        const auto &from_table = from_tables[i];
+                        const auto &to_table = to_tables[i];
+                        if (to_table[root] != INFINITE_DISTANCE && to_table[node] != INFINITE_DISTANCE) {
+                            lower_bound = std::max<long long>(lower_bound, to_table[root] - to_table[node]);
+                        }
+                        if (from_table[node] != INFINITE_DISTANCE && from_table[root] != INFINITE_DISTANCE) {
+                            lower_bound = std::max<long long>(lower_bound, from_table[node] - from_table[root]);
+                        }
+                    }
+                    sizes[node] += distances[node] - lower_bound;
+                }
+
+                if (const auto parent = parents[node]; parent != -1) {
+                    covered[parent] |= covered[node];
+                    sizes[parent] += sizes[node];
+                    if (sizes[node] > 0 && (best_children[parent] == -1
+                                            || sizes[node] > sizes[best_children[parent]])) {
+                        best_children[parent] = node;
+                    }
+                }
+            }
+
+            // descend from the largest subtree to a leaf along the largest children
+            auto landmark = *std::max_element(settle_order.begin(), settle_order.end(), [&sizes](int a, int b) {
+                return sizes[a] < sizes[b];
+            });
+            if (sizes[landmark] == 0) {
+                // the tree of the root is covered, fall back to a random node
+                if (static_cast<int>(landmarks.size()) >= node_count)
+                    break;
+                do {
+                    landmark = random_node(generator);
+                } while (is_landmark[landmark]);
+            } else {
+                while (best_children[landmark] != -1) {
+                    landmark = best_children[landmark];
+                }
+            }
+
+            // the tables of the chosen landmarks are needed for the lower bounds of the next round
+            compute_distances(graph, landmark, false, from_tables[landmarks.size()]);
+            compute_distances(graph, landmark, true, to_tables[landmarks.size()]);
+            is_landmark[landmark] = true;
+            landmarks.push_back(landmark);
+        }
+
+        return landmarks;
+    }
+
+    LandmarkIndex::LandmarkIndex(const Graph &graph, int landmark_count, const LandmarkSelection selection,
+                                 const int thread_count) : m_graph(&graph) {
+        const auto node_count = graph.get_node_count();
+        landmark_count = std::clamp(landmark_count, 0, node_count);
+        if (landmark_count == 0)
+            return;
+
+        std::vector<std::vector<int> > from_tables(landmark_count);
+        std::vector<std::vector<int> > to_tables(landmark_count);
+        if (selection == LandmarkSelection::Farthest) {
+            m_landmarks = select_farthest_landmarks(graph, landmark_count, from_tables);
+        } else {
+            m_landmarks = select_avoid_landmarks(graph, landmark_count, from_tables, to_tables);
+        }
+        landmark_count = static_cast<int>(m_landmarks.size());
+
+        // the searches of the landmarks are independent, the selection only computed some of them
+        parallel_for_chunks(landmark_count, thread_count, [&](const size_t begin, const size_t end) {
+            for (auto i = begin; i < end; ++i) {
+                if (from_tables[i].empty()) {
+                    compute_distances(graph, m_landmarks[i], false, from_tables[i]);
+                }
+                if (to_tables[i].empty()) {
+                    compute_distances(graph, m_landmarks[i], true, to_tables[i]);
+                }
+            }
+        });
+
+        m_distances.resize(static_cast<size_t>(node_count) * landmark_count);
+        parallel_for_chunks(node_count, thread_count, [&](const size_t begin, const size_t end) {
+            for (auto node = begin; node < end; ++node) {
+                for (int i = 0; i < landmark_count; ++i) {
+                    m_distances[node * landmark_count + i] = LandmarkDistance{from_tables[i][node], to_tables[i][node]};
+                }
+            }
+        });
+    }
+
+    int LandmarkIndex::compute_lower_bound(const LandmarkDistance *node_distances,
+                                           const LandmarkDistance *target_distances) const {
+        int lower_bound = 0;
+        for (size_t i = 0; i < m_landmarks.size(); ++i) {
+            const auto [from_node, to_node] = node_distances[i];
+            const auto [from_target, to_target] = target_distances[i];
+
+            // d(v, t) >= d(v, L) - d(t, L), if only the target reaches the landmark, the node can't reach the target
+            if (to_target != INFINITE_DISTANCE) {
+                if (to_node == INFINITE_DISTANCE)
+                    return INFINITE_DISTANCE;
+                lower_bound = std::max(lower_bound, to_node - to_target);
+            }
+            // d(v, t) >= d(L, t) - d(L, v)
+            if (from_target != INFINITE_DISTANCE && from_node != INFINITE_DISTANCE) {
+                lower_bound = std::max(lower_bound, from_target - from_node);
+            }
+        }
+        return lower_bound;
+    }
+
+    int LandmarkIndex::compute_lower_bound(const int node, const int target) const {
+        return compute_lower_bound(get_distances(node), get_distances(target));
+    }
+
+    int LandmarkIndex::compute_shortest_path(const int source, const int target) const {
+        thread_local AStarWorkspace<> workspace;
+        return compute_shortest_path(source, target, workspace);
+    }
+
+    template<typename Queue>
+    int LandmarkIndex::compute_shortest_path(const int source, const int target,
+                                             AStarWorkspace<Queue> &workspace) const {
+        workspace.reset(m_graph->get_node_count());
+        if (!m_graph->may_be_connected(source, target))
+            return -1;
+
+        auto &distances = workspace.search.distances;
+        auto &queue = workspace.search.queue;
+        auto &potentials = workspace.potentials;
+        const auto target_distances = get_distances(target);
+
+        const auto source_potential = compute_lower_bound(get_distances(source), target_distances);
+        if (source_potential == INFINITE_DISTANCE)
+            return -1;
+
+        distances.set(source, 0);
+        potentials.set(source, source_potential);
+        queue.push(source, source_potential);
+
+        while (!queue.empty()) {
+            const auto [index, key] = queue.pop();
+            const auto distance = distances.get(index);
+
+            // the key was pushed with an older, longer distance
+            if (key - potentials.get(index) > distance) {
+                continue;
+            }
+            workspace.search.settled_nodes++;
+
+            if (index == target) {
+                break;
+            }
+
+            for (const auto [neighbour_index, weight]: m_graph->get_out_edges(index)) {
+                const auto new_distance = distance + weight;
+                if (new_distance >= distances.get(neighbour_index)) {
+                    continue;
+                }
+
+                // nodes that can't reach the target get no potential and are never queued
+                auto potential = potentials.get(neighbour_index);
+                if (potential == INFINITE_DISTANCE) {
+                    potential = compute_lower_bound(get_distances(neighbour_index), target_distances);
+                    if (potential == INFINITE_DISTANCE)
+                        continue;
+                    potentials.set(neighbour_index, potential);
+                }
+
+                distances.set(neighbour_index, new_distance);
+                queue.push(neighbour_index, new_distance + potential);
+            }
+        }
+
+        if (distances.get(target) == INFINITE_DISTANCE)
+            return -1;
+
+        return distances.get(target);
+    }
+
+    template int LandmarkIndex::compute_shortest_path(int, int, AStarWorkspace<BinaryHeap> &) const;
+    template int LandmarkIndex::compute_shortest_path(int, int, AStarWorkspace<QuaternaryHeap> &) const;
+    template int LandmarkIndex::compute_shortest_path(int, int, AStarWorkspace<RadixHeap> &) const;
+
+    const std::vector<int> &LandmarkIndex::get_landmarks() const {
+        return m_landmarks;
+    }
+} // exercise::one
@@ -0,0 +1,62 @@
+//
+// Created by Jost on 17/10/2026.
+//
+
+#ifndef LANDMARKS_H
+#define LANDMARKS_H
+
+#include <thread>
+#include <vector>
+
+#include "graph.h"
+#include "query_workspace.h"
+
+namespace exercise::one {
+    enum class LandmarkSelection {
+        // every new landmark is the node farthest away from the ones chosen so far
+        Farthest,
+        // every new landmark is a leaf of the shortest path tree region whose distances the chosen ones
+        // estimate worst (Goldberg & Werneck)
+        Avoid,
+    };
+
+    /// Distances from and to all landmarks for the A* search with landmarks (ALT). By the triangle inequality
+    /// d(v, t) >= d(v, L) - d(t, L) and d(v, t) >= d(L, t) - d(L, v) for every landmark L, which gives a
+    /// consistent potential that leads the search towards the target.
+    class LandmarkIndex {
+    public:
+        LandmarkIndex(const Graph &graph, int landmark_count, LandmarkSelection selection,
+                      int thread_count = static_cast<int>(std::thread::hardware_concurrency()));
+
+        [[nodiscard]] int compute_shortest_path(int source, int target) const;
+        /// Instantiated for the BinaryHeap, QuaternaryHeap and RadixHeap queues
+        template<typename Queue>
+        [[nodiscard]] int compute_shortest_path(int source, int target, AStarWorkspace<Queue> &workspace) const;
+
+        /// Lower bound of the distance from node to target,
+        /// TimestampedDistances::INFINITE_DISTANCE if node can't reach the target
+        [[nodiscard]] int compute_lower_bound(int node, int target) const;
+
+        [[nodiscard]] const std::vector<int> &get_landmarks() const;
+
+    private:
+        struct LandmarkDistance {
+            int from_landmark;
+            int to_landmark;
+        };
+
+        const Graph *m_graph;
+        std::vector<int> m_landmarks;
+        // node major, the distances of one node to all landmarks share a few cache lines
+        std::vector<LandmarkDistance> m_distances;
+
+        [[nodiscard]] const LandmarkDistance *get_distances(const int node) const {
+            return m_distances.data() + static_cast<size_t>(node) * m_landmarks.size();
+        }
+
+        [[nodiscard]] int compute_lower_bound(const LandmarkDistance *node_distances,
+                                              const LandmarkDistance *target_distances) const;
+    };
+} // exercise::one
+
+#endif //LANDMARKS_H
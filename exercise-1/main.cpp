@@ -1,22 +1,36 @@
+#include <algorithm>
 #include <charconv>
+#include <cstdlib>
 #include <iostream>
 #include <filesystem>
 #include <fstream>
+#include <iomanip>
+#include <optional>
 #include <string>
+#include <thread>
 
+#include "batch_queries.h"
+#include "benchmarks.h"
+#include "buffered_writer.h"
 #include "graph.h"
+#include "mapped_file.h"
+#include "query_workspace.h"
 #include "Stopwatch.h"
 
 namespace fs = std::filesystem;
 
 constexpr int DIJKSTRA_ITERATIONS = 100;
+constexpr int BENCHMARK_EDGE_COUNT = 20'000'000;
+constexpr int LANDMARK_COUNT = 16;
 
 const std::string default_graph_file_name = "graph.fmi";
 const std::string default_query_file_name = "queries.txt";
 const std::string default_result_file_name = "result.txt";
+const std::string snapshot_file_extension = ".snapshot";
 
 static void handle_query_file(std::fstream query_file, std::fstream result_file, const exercise::one::Graph &graph) {
-    auto sw = Stopwatch::Start();
+    exercise::one::QueryWorkspace<> workspace(graph.get_node_count());
+    auto sw = Stopwatch<std::chrono::milliseconds>::Start();
     std::string line;
     while (std::getline(query_file, line)) {
         int start, target;
@@ -25,7 +39,7 @@ static void handle_query_file(std::fstream query_file, std::fstream result_file,
         std::from_chars(line.data() + seperator + 1, line.data() + line.size(), target);
 
         sw.Restart();
-        const auto dist = graph.compute_shortest_path_dijkstra(start, target);
+        const auto dist = graph.compute_shortest_path_dijkstra(start, target, workspace);
         const auto time = sw.Split();
 
         result_file << start << " " << target << " " << dist << " " << time << "\n";
@@ -35,7 +49,206 @@ static void handle_query_file(std::fstream query_file, std::fstream result_file,
     result_file.close();
 }
 
+static void handle_snapshot(const std::string &graph_file_name) {
+    const auto snapshot_file_name = graph_file_name + snapshot_file_extension;
+
+    std::cout << "Creating graph from file: '" << graph_file_name << "'" << std::endl;
+    auto sw = Stopwatch<std::chrono::milliseconds>::Start();
+    const auto graph = exercise::one::Graph(exercise::one::MappedFile(graph_file_name));
+    std::cout << "Created in " << sw.Stop() << "ms\n" << std::endl;
+
+    sw.Restart();
+    if (!graph.save(snapshot_file_name)) {
+        std::cout << "Couldn't write '" << snapshot_file_name << "' file!" << std::endl;
+        return;
+    }
+    std::cout << "Snapshot written to '" << snapshot_file_name << "' in " << sw.Stop() << "ms" << std::endl;
+
+    sw.Restart();
+    const auto loaded_graph = exercise::one::Graph::from_snapshot(snapshot_file_name);
+    const auto load_time = sw.Stop();
+    if (!loaded_graph) {
+        std::cout << "Couldn't read back '" << snapshot_file_name << "' file!" << std::endl;
+        return;
+    }
+    std::cout << "Snapshot loaded in " << load_time << "ms" << std::endl;
+}
+
+static void handle_batch(const std::string &graph_file_name, const std::string &query_file_name,
+                         const int thread_count) {
+    std::cout << "Creating graph from file: '" << graph_file_name << "'" << std::endl;
+    auto sw = Stopwatch<std::chrono::milliseconds>::Start();
+    auto graph = fs::path(graph_file_name).extension() == snapshot_file_extension
+                     ? exercise::one::Graph::from_snapshot(graph_file_name)
+                     : std::optional(exercise::one::Graph(exercise::one::MappedFile(graph_file_name)));
+    if (!graph) {
+        std::cout << "Couldn't open '" << graph_file_name << "' file!" << std::endl;
+        return;
+    }
+    // the components let the queries reject unreachable targets right away
+    graph->compute_weakly_connected_components(thread_count);
+    std::cout << "Created in " << sw.Stop() << "ms\n" << std::endl;
+
+    const exercise::one::MappedFile query_file(query_file_name);
+    if (!query_file.is_open()) {
+        std::cout << "Couldn't open '" << query_file_name << "' file!" << std::endl;
+        return;
+    }
+    const auto queries = exercise::one::parse_query_file(query_file);
+
+    std::cout << "Processing " << queries.size() << " queries from file '" << query_file_name << "' on "
+            << thread_count << " threads" << std::endl;
+    const auto statistics = exercise::one::handle_query_batch(*graph, queries, default_result_file_name,
+                                                              thread_count);
+    std::cout << "Results written to '" << default_result_file_name << "'.\n" << std::endl;
+
+    std::cout << "[BENCHMARK] Total time:       " << std::setw(12) << statistics.total_time_us << " us" << std::endl;
+    std::cout << "[BENCHMARK] Throughput:       " << std::setw(12) << static_cast<long long>(statistics.queries_per_second)
+            << " queries/s" << std::endl;
+    std::cout << "[BENCHMARK] Latency p50:      " << std::setw(12) << statistics.latency_p50_us << " us" << std::endl;
+    std::cout << "[BENCHMARK] Latency p90:      " << std::setw(12) << statistics.latency_p90_us << " us" << std::endl;
+    std::cout << "[BENCHMARK] Latency p99:      " << std::setw(12) << statistics.latency_p99_us << " us" << std::endl;
+    std::cout << "[BENCHMARK] Latency max:      " << std::setw(12) << statistics.latency_max_us << " us" << std::endl;
+}
+
+static void handle_largest_component(const std::string &graph_file_name, const std::string &query_file_name) {
+    std::cout << "Creating graph from file: '" << graph_file_name << "'" << std::endl;
+    auto sw = Stopwatch<std::chrono::milliseconds>::Start();
+    const auto graph = exercise::one::Graph(exercise::one::MappedFile(graph_file_name));
+    std::cout << "Created in " << sw.Stop() << "ms\n" << std::endl;
+
+    sw.Restart();
+    std::vector<int> node_components;
+    const auto component_count = graph.compute_strongly_connected_components(node_components);
+    std::cout << "The graph has " << component_count << " strongly connected components, computed in "
+            << sw.Stop() << "ms" << std::endl;
+
+    sw.Restart();
+    std::vector<int> node_index_map;
+    const auto component = graph.extract_largest_strongly_connected_component(node_index_map);
+    std::cout << "The largest one has " << component.get_node_count() << " of " << graph.get_node_count()
+            << " nodes, extracted in " << sw.Stop() << "ms\n" << std::endl;
+
+    const exercise::one::MappedFile query_file(query_file_name);
+    if (!query_file.is_open()) {
+        std::cout << "Couldn't open '" << query_file_name << "' file!" << std::endl;
+        return;
+    }
+    const auto queries = exercise::one::parse_query_file(query_file);
+
+    // queries with an end outside the component are answered with -1 without a search
+    std::cout << "Processing " << queries.size() << " queries from file '" << query_file_name
+            << "' inside the largest component" << std::endl;
+    exercise::one::QueryWorkspace<> full_workspace(graph.get_node_count());
+    exercise::one::QueryWorkspace<> component_workspace(component.get_node_count());
+    auto query_sw = Stopwatch<std::chrono::microseconds>::Start();
+    long long full_time = 0;
+    long long component_time = 0;
+    int rejected_count = 0;
+    exercise::one::BufferedWriter result_file(default_result_file_name);
+    for (const auto &[source, target]: queries) {
+        query_sw.Restart();
+        [[maybe_unused]] const auto full_distance = graph.compute_shortest_path_dijkstra(source, target, full_workspace);
+        full_time += query_sw.Split();
+
+        query_sw.Restart();
+        int distance = -1;
+        if (node_index_map[source] != -1 && node_index_map[target] != -1) {
+            distance = component.compute_shortest_path_dijkstra(node_index_map[source], node_index_map[target],
+                                                                component_workspace);
+        } else {
+            rejected_count++;
+        }
+        const auto time = query_sw.Split();
+        component_time += time;
+
+        result_file << source << ' ' << target << ' ' << distance << ' ' << time / 1000 << '\n';
+    }
+    result_file.close();
+    std::cout << "Results written to '" << default_result_file_name << "'.\n" << std::endl;
+
+    const auto query_count = static_cast<long long>(std::max<size_t>(1, queries.size()));
+    std::cout << "[BENCHMARK] Full graph:         " << std::setw(12) << full_time / query_count << " us" << std::endl;
+    std::cout << "[BENCHMARK] Largest component:  " << std::setw(12) << component_time / query_count << " us"
+            << std::endl;
+    std::cout << "[BENCHMARK] Rejected queries:   " << std::setw(12) << rejected_count << std::endl;
+}
+
+static int handle_mode(const int argc, char *argv[]) {
+    const std::string mode = argv[1];
+
+    // synthetic benchmarks, the optional argument is the amount of edges
+    if (mode == "-bench-csr") {
+        int edge_count = BENCHMARK_EDGE_COUNT;
+        if (argc > 2) {
+            edge_count = std::max(1, std::atoi(argv[2]));
+        }
+        exercise::one::benchmark_construction(edge_count);
+        return 0;
+    }
+
+    std::string graph_file_name = default_graph_file_name;
+    if (argc > 2) {
+        graph_file_name = argv[2];
+    }
+    if (!fs::exists(graph_file_name)) {
+        std::cout << "Couldn't find '" << graph_file_name << "' file!" << std::endl;
+        return 1;
+    }
+
+    if (mode == "-bench-load") {
+        exercise::one::benchmark_loading(graph_file_name);
+    } else if (mode == "-bench-queue") {
+        exercise::one::benchmark_queues(graph_file_name, DIJKSTRA_ITERATIONS);
+    } else if (mode == "-snapshot") {
+        handle_snapshot(graph_file_name);
+    } else if (mode == "-bench-p2p") {
+        // optional arguments: query file and amount of landmarks
+        const std::string query_file_name = argc > 3 ? argv[3] : default_query_file_name;
+        if (!fs::exists(query_file_name)) {
+            std::cout << "Couldn't find '" << query_file_name << "' file!" << std::endl;
+            return 1;
+        }
+        int landmark_count = LANDMARK_COUNT;
+        if (argc > 4) {
+            landmark_count = std::max(1, std::atoi(argv[4]));
+        }
+        exercise::one::benchmark_point_to_point(graph_file_name, query_file_name, landmark_count);
+    } else if (mode == "-scc") {
+        const std::string query_file_name = argc > 3 ? argv[3] : default_query_file_name;
+        if (!fs::exists(query_file_name)) {
+            std::cout << "Couldn't find '" << query_file_name << "' file!" << std::endl;
+            return 1;
+        }
+        handle_largest_component(graph_file_name, query_file_name);
+    } else if (mode == "-batch") {
+        // optional arguments: query file and thread count, defaults to all hardware threads
+        const std::string query_file_name = argc > 3 ? argv[3] : default_query_file_name;
+        if (!fs::exists(query_file_name)) {
+            std::cout << "Couldn't find '" << query_file_name << "' file!" << std::endl;
+            return 1;
+        }
+        int thread_count = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        if (argc > 4) {
+            thread_count = std::max(1, std::atoi(argv[4]));
+        }
+        handle_batch(graph_file_name, query_file_name, thread_count);
+    } else {
+        std::cout << "[Error] Unknown mode '" << mode
+                << "', must be one of [-bench-load, -bench-csr, -bench-queue, -bench-p2p, -snapshot, -batch, -scc]." << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
 int main(const int argc, char *argv[]) {
+    // benchmarks and tools are selected by an option in front of the graph file,
+    // e.g. './exercise-1 -bench-load graph.fmi'
+    if (argc > 1 && argv[1][0] == '-') {
+        return handle_mode(argc, argv);
+    }
+
     std::string graph_file_name = default_graph_file_name;
     if (argc > 1) {
         graph_file_name = argv[1];
@@ -44,16 +257,21 @@ int main(const int argc, char *argv[]) {
         std::cout << "Couldn't find '" << graph_file_name << "' file!" << std::endl;
         return 1;
     }
-    std::fstream graph_file(graph_file_name, std::ios::in);
-    if (!graph_file.is_open()) {
-        std::cout << "Couldn't open '" << graph_file_name << "' file!" << std::endl;
-        return 1;
-    }
 
     // problem 1
     std::cout << "Creating graph from file: '" << graph_file_name << "'" << std::endl;
-    auto sw = Stopwatch::Start();
-    const auto graph = exercise::one::Graph(std::move(graph_file));
+    auto sw = Stopwatch<std::chrono::milliseconds>::Start();
+    std::optional<exercise::one::Graph> loaded_graph;
+    if (fs::path(graph_file_name).extension() == snapshot_file_extension) {
+        loaded_graph = exercise::one::Graph::from_snapshot(graph_file_name);
+    } else if (const exercise::one::MappedFile graph_file(graph_file_name); graph_file.is_open()) {
+        loaded_graph.emplace(graph_file);
+    }
+    if (!loaded_graph) {
+        std::cout << "Couldn't open '" << graph_file_name << "' file!" << std::endl;
+        return 1;
+    }
+    auto &graph = *loaded_graph;
     std::cout << "Created in " << sw.Stop() << "ms\n" << std::endl;
 
     // problem 2
@@ -65,16 +283,18 @@ int main(const int argc, char *argv[]) {
 
     // problem 4
     std::cout << "Calculating " << DIJKSTRA_ITERATIONS << " shortest path queries:" << std::endl;
+    exercise::one::QueryWorkspace<> workspace(graph.get_node_count());
+    auto query_sw = Stopwatch<std::chrono::microseconds>::Start();
     long long overall_time = 0;
     for (int i = 0; i < DIJKSTRA_ITERATIONS; ++i) {
         const int start = std::rand() % graph.get_node_count();
         const int end = std::rand() % graph.get_node_count();
 
-        sw.Restart();
-        const auto dist = graph.compute_shortest_path_dijkstra(start, end);
-        overall_time += sw.Split();
+        query_sw.Restart();
+        const auto dist = graph.compute_shortest_path_dijkstra(start, end, workspace);
+        overall_time += query_sw.Split();
     }
-    std::cout << "Computed in average of " << overall_time / DIJKSTRA_ITERATIONS << "ms\n" << std::endl;
+    std::cout << "Computed in average of " << overall_time / DIJKSTRA_ITERATIONS << "us\n" << std::endl;
 
     // problem 5
     std::string query_file_name = default_query_file_name;
@@ -0,0 +1,132 @@
+//
+// Created by Jost on 17/10/2026.
+//
+
+#include "mapped_file.h"
+
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace exercise::one {
+#ifdef _WIN32
+    MappedFile::MappedFile(const std::string &file_name) {
+        const auto file = CreateFileA(file_name.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                      FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            return;
+
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(file, &file_size)) {
+            CloseHandle(file);
+            return;
+        }
+        m_size = static_cast<size_t>(file_size.QuadPart);
+
+        // an empty file can not be mapped, but is still a valid (empty) input
+        if (m_size == 0) {
+            CloseHandle(file);
+            m_is_open = true;
+            return;
+        }
+
+        const auto mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (mapping == nullptr)
+            return;
+
+        m_data = static_cast<const char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        CloseHandle(mapping);
+        m_is_open = m_data != nullptr;
+    }
+
+    void MappedFile::close() {
+        if (m_data != nullptr) {
+            UnmapViewOfFile(m_data);
+        }
+        m_data = nullptr;
+        m_size = 0;
+        m_is_open = false;
+    }
+#else
+    MappedFile::MappedFile(const std::string &file_name) {
+        const int file = open(file_name.c_str(), O_RDONLY);
+        if (file < 0)
+            return;
+
+        struct stat file_stat{};
+        if (fstat(file, &file_stat) != 0) {
+            ::close(file);
+            return;
+        }
+        m_size = static_cast<size_t>(file_stat.st_size);
+
+        // an empty file can not be mapped, but is still a valid (empty) input
+        if (m_size == 0) {
+            ::close(file);
+            m_is_open = true;
+            return;
+        }
+
+        void *mapping = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+        ::close(file);
+        if (mapping == MAP_FAILED)
+            return;
+
+        // the file is read front to back, so let the kernel read ahead aggressively
+        madvise(mapping, m_size, MADV_SEQUENTIAL);
+
+        m_data = static_cast<const char *>(mapping);
+        m_is_open = true;
+    }
+
+    void MappedFile::close() {
+        if (m_data != nullptr) {
+            munmap(const_cast<char *>(m_data), m_size);
+        }
+        m_data = nullptr;
+        m_size = 0;
+        m_is_open = false;
+    }
+#endif
+
+    MappedFile::~MappedFile() {
+        close();
+    }
+
+    MappedFile::MappedFile(MappedFile &&other) noexcept: m_data(std::exchange(other.m_data, nullptr)),
+                                                         m_size(std::exchange(other.m_size, 0)),
+                                                         m_is_open(std::exchange(other.m_is_open, false)) {
+    }
+
+    MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+        if (this != &other) {
+            close();
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+            m_is_open = std::exchange(other.m_is_open, false);
+        }
+        return *this;
+    }
+
+    bool MappedFile::is_open() const {
+        return m_is_open;
+    }
+
+    const char *MappedFile::data() const {
+        return m_data;
+    }
+
+    size_t MappedFile::size() const {
+        return m_size;
+    }
+} // exercise::one
@@ -0,0 +1,42 @@
+//
+// Created by Jost on 17/10/2026.
+//
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+namespace exercise::one {
+    /// Read-only memory mapping of a whole file, the mapping is released when the object is destroyed
+    class MappedFile {
+    public:
+        explicit MappedFile(const std::string &file_name);
+
+        ~MappedFile();
+
+        MappedFile(const MappedFile &) = delete;
+
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        MappedFile(MappedFile &&other) noexcept;
+
+        MappedFile &operator=(MappedFile &&other) noexcept;
+
+        [[nodiscard]] bool is_open() const;
+
+        [[nodiscard]] const char *data() const;
+
+        [[nodiscard]] size_t size() const;
+
+    private:
+        const char *m_data = nullptr;
+        size_t m_size = 0;
+        bool m_is_open = false;
+
+        void close();
+    };
+} // exercise::one
+
+#endif //MAPPED_FILE_H
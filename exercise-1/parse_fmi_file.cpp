@@ -0,0 +1,261 @@
+//
+// Created by Jost on 17/10/2026.
+//
+
+#include "parse_fmi_file.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <string>
+#include <thread>
+
+namespace exercise::one {
+    enum READ_STATE {
+        META,
+        NODE_COUNT,
+        EDGE_COUNT,
+        NODES,
+        EDGES,
+        FINISHED
+    };
+
+    static FMIEdge parse_edge(const std::string_view line) {
+        const auto from_end = line.find(' ');
+        const auto to_start = from_end + 1;
+        const auto to_end = line.find(' ', to_start);
+        const auto weight_start = to_end + 1;
+        const auto weight_end = line.find(' ', weight_start);
+
+        int from, to, weight;
+        std::from_chars(line.data(), line.data() + from_end, from);
+        std::from_chars(line.data() + to_start, line.data() + to_end, to);
+        std::from_chars(line.data() + weight_start, line.data() + weight_end, weight);
+
+        return FMIEdge{from, to, weight};
+    }
+
+    /// Reads "id osm_id latitude longitude ..." and stores the coordinates at the id
+    static void parse_node(const std::string_view line, FMINodes &nodes) {
+        const auto id_end = line.find(' ');
+        const auto latitude_start = line.find(' ', id_end + 1) + 1;
+        const auto latitude_end = line.find(' ', latitude_start);
+        const auto longitude_start = latitude_end + 1;
+        const auto longitude_end = std::min(line.find(' ', longitude_start), line.size());
+
+        int id = -1;
+        float latitude = 0, longitude = 0;
+        std::from_chars(line.data(), line.data() + id_end, id);
+        std::from_chars(line.data() + latitude_start, line.data() + latitude_end, latitude);
+        std::from_chars(line.data() + longitude_start, line.data() + longitude_end, longitude);
+
+        if (id >= 0 && id < static_cast<int>(nodes.latitudes.size())) {
+            nodes.latitudes[id] = latitude;
+            nodes.longitudes[id] = longitude;
+        }
+    }
+
+    int parse_fmi_file(std::fstream input_file, FMINodes &nodes, std::vector<FMIEdge> &edges) {
+        int node_count = 0;
+
+        auto state = READ_STATE::META;
+        int node_index = 0;
+        int edge_index = 0;
+
+        std::string line;
+        while (std::getline(input_file, line)) {
+            switch (state) {
+                case READ_STATE::META:
+                    // metadata section ends with an empty line
+                    if (line.empty()) {
+                        state = READ_STATE::NODE_COUNT;
+                    }
+                    break;
+
+                case READ_STATE::NODE_COUNT:
+                    node_count = std::stoi(line);
+                    nodes.latitudes.assign(node_count, 0);
+                    nodes.longitudes.assign(node_count, 0);
+                    state = READ_STATE::EDGE_COUNT;
+                    break;
+
+                case READ_STATE::EDGE_COUNT:
+                    edges.resize(std::stoi(line));
+                    state = READ_STATE::NODES;
+                    break;
+
+                case READ_STATE::NODES:
+                    parse_node(line, nodes);
+                    node_index++;
+                    if (node_index >= node_count) {
+                        state = READ_STATE::EDGES;
+                    }
+                    break;
+
+                case READ_STATE::EDGES:
+                    edges[edge_index] = parse_edge(line);
+                    edge_index++;
+                    if (edge_index >= edges.size()) {
+                        state = READ_STATE::FINISHED;
+                    }
+                    break;
+
+                case READ_STATE::FINISHED:
+                    break;
+            }
+        }
+        input_file.close();
+
+        return node_count;
+    }
+
+    /// Returns the start of the line following the one cursor points into
+    static const char *next_line(const char *cursor, const char *end) {
+        const auto line_end = static_cast<const char *>(std::memchr(cursor, '\n', end - cursor));
+        return line_end == nullptr ? end : line_end + 1;
+    }
+
+    static int parse_int(const char *&cursor, const char *end) {
+        while (cursor < end && *cursor == ' ') {
+            ++cursor;
+        }
+
+        int value = 0;
+        cursor = std::from_chars(cursor, end, value).ptr;
+        return value;
+    }
+
+    static bool is_empty_line(const char *cursor, const char *end) {
+        return cursor == end || *cursor == '\n' || (*cursor == '\r' && cursor + 1 < end && cursor[1] == '\n');
+    }
+
+    static float parse_float(const char *&cursor, const char *end) {
+        while (cursor < end && *cursor == ' ') {
+            ++cursor;
+        }
+
+        float value = 0;
+        cursor = std::from_chars(cursor, end, value).ptr;
+        return value;
+    }
+
+    static void skip_field(const char *&cursor, const char *end) {
+        while (cursor < end && *cursor == ' ') {
+            ++cursor;
+        }
+        while (cursor < end && *cursor != ' ' && *cursor != '\n') {
+            ++cursor;
+        }
+    }
+
+    /// Splits the lines in [begin, end) into chunks and parses them on thread_count threads.
+    /// parse_line(index, cursor, chunk_end) is called for the index-th line, at most line_count lines are parsed
+    template<typename LineParser>
+    static void parse_lines_in_chunks(const char *begin, const char *end, const int line_count, int thread_count,
+                                      const LineParser &parse_line) {
+        // split the section into chunks that start at line boundaries
+        thread_count = std::max(1, thread_count);
+        const auto section_size = end - begin;
+        std::vector<const char *> chunk_starts(thread_count + 1);
+        chunk_starts[0] = begin;
+        for (int i = 1; i < thread_count; ++i) {
+            const auto split = begin + section_size * i / thread_count;
+            chunk_starts[i] = std::max(chunk_starts[i - 1], split == begin ? begin : next_line(split - 1, end));
+        }
+        chunk_starts[thread_count] = end;
+
+        // first pass: count the lines of each chunk to know the index of its first line
+        std::vector<int> chunk_first_line(thread_count + 1, 0);
+        {
+            std::vector<std::thread> threads;
+            threads.reserve(thread_count);
+            for (int i = 0; i < thread_count; ++i) {
+                threads.emplace_back([&chunk_starts, &chunk_first_line, i]() {
+                    const auto chunk_begin = chunk_starts[i];
+                    const auto chunk_end = chunk_starts[i + 1];
+                    auto chunk_line_count = std::count(chunk_begin, chunk_end, '\n');
+                    if (chunk_end > chunk_begin && chunk_end[-1] != '\n') {
+                        chunk_line_count++;
+                    }
+                    chunk_first_line[i + 1] = static_cast<int>(chunk_line_count);
+                });
+            }
+            for (auto &thread: threads) {
+                thread.join();
+            }
+        }
+        for (int i = 0; i < thread_count; ++i) {
+            chunk_first_line[i + 1] += chunk_first_line[i];
+        }
+
+        // second pass: parse every chunk, each line knows its index
+        {
+            std::vector<std::thread> threads;
+            threads.reserve(thread_count);
+            for (int i = 0; i < thread_count; ++i) {
+                threads.emplace_back([&chunk_starts, &chunk_first_line, &parse_line, line_count, i]() {
+                    const char *line = chunk_starts[i];
+                    const auto chunk_end = chunk_starts[i + 1];
+                    for (int line_index = chunk_first_line[i]; line_index < line_count && line < chunk_end;
+                         ++line_index) {
+                        const char *field = line;
+                        parse_line(line_index, field, chunk_end);
+                        line = next_line(field, chunk_end);
+                    }
+                });
+            }
+            for (auto &thread: threads) {
+                thread.join();
+            }
+        }
+    }
+
+    int parse_fmi_file(const MappedFile &input_file, FMINodes &nodes, std::vector<FMIEdge> &edges,
+                       const int thread_count) {
+        const char *cursor = input_file.data();
+        const char *end = cursor + input_file.size();
+
+        // metadata section ends with an empty line
+        while (cursor < end && !is_empty_line(cursor, end)) {
+            cursor = next_line(cursor, end);
+        }
+        cursor = next_line(cursor, end);
+
+        const int node_count = parse_int(cursor, end);
+        cursor = next_line(cursor, end);
+        const int edge_count = parse_int(cursor, end);
+        cursor = next_line(cursor, end);
+
+        // the node section has to be skipped once anyway to find the start of the edges
+        const char *node_section = cursor;
+        for (int i = 0; i < node_count && cursor < end; ++i) {
+            cursor = next_line(cursor, end);
+        }
+        const char *edge_section = cursor;
+
+        nodes.latitudes.assign(node_count, 0);
+        nodes.longitudes.assign(node_count, 0);
+        parse_lines_in_chunks(node_section, edge_section, node_count, thread_count,
+                              [&nodes, node_count](int, const char *&field, const char *chunk_end) {
+                                  const int id = parse_int(field, chunk_end);
+                                  skip_field(field, chunk_end);
+                                  const float latitude = parse_float(field, chunk_end);
+                                  const float longitude = parse_float(field, chunk_end);
+                                  if (id >= 0 && id < node_count) {
+                                      nodes.latitudes[id] = latitude;
+                                      nodes.longitudes[id] = longitude;
+                                  }
+                              });
+
+        edges.resize(edge_count);
+        parse_lines_in_chunks(edge_section, end, edge_count, thread_count,
+                              [&edges](const int edge_index, const char *&field, const char *chunk_end) {
+                                  const int from = parse_int(field, chunk_end);
+                                  const int to = parse_int(field, chunk_end);
+                                  const int weight = parse_int(field, chunk_end);
+                                  edges[edge_index] = FMIEdge{from, to, weight};
+                              });
+
+        return node_count;
+    }
+} // exercise::one
@@ -0,0 +1,33 @@
+//
+// Created by Jost on 17/10/2026.
+//
+
+#ifndef PARSE_FMI_FILE_H
+#define PARSE_FMI_FILE_H
+
+#include <fstream>
+#include <vector>
+
+#include "mapped_file.h"
+
+namespace exercise::one {
+    struct FMIEdge {
+        int from, to;
+        int weight;
+    };
+
+    /// Coordinates of the nodes in degrees, indexed by node id
+    struct FMINodes {
+        std::vector<float> latitudes;
+        std::vector<float> longitudes;
+    };
+
+    /// Parses the fmi file line by line and returns the node count
+    int parse_fmi_file(std::fstream input_file, FMINodes &nodes, std::vector<FMIEdge> &edges);
+
+    /// Parses the fmi file directly from the mapped bytes, the node and edge sections are parsed in chunks on
+    /// multiple threads. Returns the node count
+    int parse_fmi_file(const MappedFile &input_file, FMINodes &nodes, std::vector<FMIEdge> &edges, int thread_count);
+} // exercise::one
+
+#endif //PARSE_FMI_FILE_H
@@ -0,0 +1,125 @@
+//
+// Created by Jost on 17/10/2026.
+//
+
+#ifndef QUERY_WORKSPACE_H
+#define QUERY_WORKSPACE_H
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "priority_queues.h"
+
+namespace exercise::one {
+    /// Distance array that is reset in O(1): every entry remembers the query it was written in,
+    /// entries of older queries read as infinity.
+    class TimestampedDistances {
+    public:
+        static constexpr int INFINITE_DISTANCE = std::numeric_limits<int>::max();
+
+        explicit TimestampedDistances(const int size = 0) {
+            resize(size);
+        }
+
+        void resize(const int size) {
+            if (size > static_cast<int>(m_entries.size())) {
+                m_entries.resize(size, Entry{INFINITE_DISTANCE, 0});
+            }
+        }
+
+        /// Invalidates all distances
+        void reset() {
+            m_timestamp++;
+
+            // after a wrap around old entries could look valid again, so they are cleared once
+            if (m_timestamp == 0) {
+                for (auto &entry: m_entries) {
+                    entry.timestamp = 0;
+                }
+                m_timestamp = 1;
+            }
+        }
+
+        [[nodiscard]] int get(const int index) const {
+            const auto &entry = m_entries[index];
+            return entry.timestamp == m_timestamp ? entry.distance : INFINITE_DISTANCE;
+        }
+
+        void set(const int index, const int distance) {
+            m_entries[index] = Entry{distance, m_timestamp};
+        }
+
+    private:
+        struct Entry {
+            int distance;
+            uint32_t timestamp;
+        };
+
+        std::vector<Entry> m_entries;
+        uint32_t m_timestamp = 1;
+    };
+
+    /// Per-thread memory of a shortest path query, it is sized once for the graph and reused by all queries,
+    /// so a query only pays for the nodes it touches.
+    template<typename Queue = BinaryHeap>
+    class QueryWorkspace {
+    public:
+        explicit QueryWorkspace(const int node_count = 0) : distances(node_count) {
+            queue.reset(node_count);
+        }
+
+        /// Prepares the workspace for a new query on a graph with node_count nodes
+        void reset(const int node_count) {
+            distances.resize(node_count);
+            distances.reset();
+            queue.reset(node_count);
+            settled_nodes = 0;
+        }
+
+        TimestampedDistances distances;
+        Queue queue;
+        /// Nodes that were taken from the queue with their final distance in the last query
+        int settled_nodes = 0;
+    };
+
+    /// Memory of a bidirectional query: one search from the source over the out edges
+    /// and one from the target over the in edges
+    template<typename Queue = BinaryHeap>
+    class BidirectionalWorkspace {
+    public:
+        explicit BidirectionalWorkspace(const int node_count = 0) : forward(node_count), backward(node_count) {
+        }
+
+        void reset(const int node_count) {
+            forward.reset(node_count);
+            backward.reset(node_count);
+        }
+
+        [[nodiscard]] int settled_nodes() const {
+            return forward.settled_nodes + backward.settled_nodes;
+        }
+
+        QueryWorkspace<Queue> forward;
+        QueryWorkspace<Queue> backward;
+    };
+
+    /// Memory of an A* query, the potential of a node is computed once when it is first reached
+    template<typename Queue = BinaryHeap>
+    class AStarWorkspace {
+    public:
+        explicit AStarWorkspace(const int node_count = 0) : search(node_count), potentials(node_count) {
+        }
+
+        void reset(const int node_count) {
+            search.reset(node_count);
+            potentials.resize(node_count);
+            potentials.reset();
+        }
+
+        QueryWorkspace<Queue> search;
+        TimestampedDistances potentials;
+    };
+} // exercise::one
+
+#endif //QUERY_WORKSPACE_H
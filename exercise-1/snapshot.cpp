@@ -0,0 +1,80 @@
+//
+// Created by Jost on 17/10/2026.
+//
+
+#include "snapshot.h"
+
+namespace exercise::one {
+    constexpr uint64_t CHECKSUM_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+    constexpr uint64_t CHECKSUM_PRIME = 0x100000001b3ULL;
+
+    // FNV-1a applied to whole 64 bit words instead of single bytes, size must be a multiple of 8
+    uint64_t update_snapshot_checksum(uint64_t checksum, const char *data, const size_t size) {
+        for (size_t i = 0; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+            uint64_t word;
+            std::memcpy(&word, data + i, sizeof(word));
+            checksum = (checksum ^ word) * CHECKSUM_PRIME;
+        }
+        return checksum;
+    }
+
+    SnapshotWriter::SnapshotWriter(const std::string &file_name, const char (&magic)[8], const uint32_t version)
+        : m_file(file_name, std::ios::out | std::ios::binary | std::ios::trunc) {
+        std::memcpy(m_header.magic, magic, sizeof(m_header.magic));
+        m_header.version = version;
+        m_header.checksum = CHECKSUM_OFFSET_BASIS;
+
+        // placeholder, rewritten in finish() once the checksum is known
+        m_file.write(reinterpret_cast<const char *>(&m_header), sizeof(m_header));
+    }
+
+    void SnapshotWriter::write_bytes(const char *data, const size_t size) {
+        const auto full_words_size = size - size % sizeof(uint64_t);
+        m_file.write(data, static_cast<std::streamsize>(full_words_size));
+        m_header.checksum = update_snapshot_checksum(m_header.checksum, data, full_words_size);
+        m_header.payload_size += full_words_size;
+
+        // pad the remaining bytes to a full word to keep every array 8 byte aligned
+        if (full_words_size != size) {
+            char last_word[sizeof(uint64_t)] = {};
+            std::memcpy(last_word, data + full_words_size, size - full_words_size);
+            m_file.write(last_word, sizeof(last_word));
+            m_header.checksum = update_snapshot_checksum(m_header.checksum, last_word, sizeof(last_word));
+            m_header.payload_size += sizeof(last_word);
+        }
+    }
+
+    bool SnapshotWriter::finish() {
+        m_file.seekp(0);
+        m_file.write(reinterpret_cast<const char *>(&m_header), sizeof(m_header));
+        m_file.close();
+        return !m_file.fail();
+    }
+
+    SnapshotReader::SnapshotReader(const std::string &file_name, const char (&magic)[8], const uint32_t version)
+        : m_file(file_name) {
+        if (!m_file.is_open() || m_file.size() < sizeof(SnapshotHeader))
+            return;
+
+        SnapshotHeader header{};
+        std::memcpy(&header, m_file.data(), sizeof(header));
+        if (std::memcmp(header.magic, magic, sizeof(header.magic)) != 0 || header.version != version)
+            return;
+
+        m_cursor = m_file.data() + sizeof(header);
+        m_end = m_file.data() + m_file.size();
+        if (header.payload_size != static_cast<uint64_t>(m_end - m_cursor))
+            return;
+
+        const auto checksum = update_snapshot_checksum(CHECKSUM_OFFSET_BASIS, m_cursor, header.payload_size);
+        m_is_valid = checksum == header.checksum;
+    }
+
+    bool SnapshotReader::is_valid() const {
+        return m_is_valid;
+    }
+
+    uint64_t SnapshotReader::padded_size(const uint64_t size) {
+        return (size + sizeof(uint64_t) - 1) / sizeof(uint64_t) * sizeof(uint64_t);
+    }
+} // exercise::one
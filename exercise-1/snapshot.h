@@ -0,0 +1,94 @@
+//
+// Created by Jost on 17/10/2026.
+//
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "mapped_file.h"
+
+namespace exercise::one {
+    /// Binary file layout:
+    ///   SnapshotHeader
+    ///   for each array: uint64 element count, uint64 element size, raw elements padded to 8 bytes
+    /// The checksum covers everything behind the header.
+    struct SnapshotHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t array_count;
+        uint64_t payload_size;
+        uint64_t checksum;
+    };
+
+    uint64_t update_snapshot_checksum(uint64_t checksum, const char *data, size_t size);
+
+    class SnapshotWriter {
+    public:
+        SnapshotWriter(const std::string &file_name, const char (&magic)[8], uint32_t version);
+
+        template<typename T>
+        void write_array(const std::vector<T> &array) {
+            static_assert(std::is_trivially_copyable_v<T>, "snapshot arrays are stored as raw bytes");
+            const uint64_t description[2] = {array.size(), sizeof(T)};
+            write_bytes(reinterpret_cast<const char *>(description), sizeof(description));
+            write_bytes(reinterpret_cast<const char *>(array.data()), array.size() * sizeof(T));
+            m_header.array_count++;
+        }
+
+        /// Writes the header with the final checksum, returns false if any write failed
+        bool finish();
+
+    private:
+        std::ofstream m_file;
+        SnapshotHeader m_header{};
+
+        void write_bytes(const char *data, size_t size);
+    };
+
+    class SnapshotReader {
+    public:
+        /// Maps the file and validates magic, version and checksum
+        SnapshotReader(const std::string &file_name, const char (&magic)[8], uint32_t version);
+
+        [[nodiscard]] bool is_valid() const;
+
+        /// Copies the next array out of the mapping, returns false if it does not fit the expected element type
+        template<typename T>
+        bool read_array(std::vector<T> &array) {
+            static_assert(std::is_trivially_copyable_v<T>, "snapshot arrays are stored as raw bytes");
+            if (!m_is_valid || m_cursor + 2 * sizeof(uint64_t) > m_end)
+                return m_is_valid = false;
+
+            uint64_t description[2];
+            std::memcpy(description, m_cursor, sizeof(description));
+            m_cursor += sizeof(description);
+
+            const auto [count, element_size] = description;
+            const auto size = count * element_size;
+            if (element_size != sizeof(T) || size > static_cast<uint64_t>(m_end - m_cursor))
+                return m_is_valid = false;
+
+            array.resize(count);
+            std::memcpy(array.data(), m_cursor, size);
+            m_cursor += padded_size(size);
+            return true;
+        }
+
+    private:
+        MappedFile m_file;
+        const char *m_cursor = nullptr;
+        const char *m_end = nullptr;
+        bool m_is_valid = false;
+
+        static uint64_t padded_size(uint64_t size);
+    };
+} // exercise::one
+
+#endif //SNAPSHOT_H
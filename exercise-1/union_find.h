@@ -0,0 +1,62 @@
+//
+// Created by Jost on 17/10/2026.
+//
+
+#ifndef UNION_FIND_H
+#define UNION_FIND_H
+
+#include <atomic>
+#include <utility>
+#include <vector>
+
+namespace exercise::one {
+    /// Lock-free disjoint sets, find and unite can be called from any amount of threads at once.
+    /// The root of a set is always its smallest element, so parents only ever decrease and every
+    /// compare and swap either makes progress or observes the progress of another thread.
+    class ConcurrentUnionFind {
+    public:
+        explicit ConcurrentUnionFind(const int size) : m_parents(size) {
+            for (int i = 0; i < size; ++i) {
+                m_parents[i].store(i, std::memory_order_relaxed);
+            }
+        }
+
+        /// Root of the set of element, halves the path on the way
+        int find(int element) {
+            while (true) {
+                auto parent = m_parents[element].load(std::memory_order_relaxed);
+                if (parent == element)
+                    return element;
+
+                const auto grandparent = m_parents[parent].load(std::memory_order_relaxed);
+                if (parent != grandparent) {
+                    // fails harmlessly if another thread already moved the element further up
+                    m_parents[element].compare_exchange_weak(parent, grandparent, std::memory_order_relaxed);
+                }
+                element = grandparent;
+            }
+        }
+
+        void unite(int a, int b) {
+            while (true) {
+                a = find(a);
+                b = find(b);
+                if (a == b)
+                    return;
+
+                // the larger root is linked below the smaller one, retry if it got linked meanwhile
+                if (a < b) {
+                    std::swap(a, b);
+                }
+                auto expected = a;
+                if (m_parents[a].compare_exchange_weak(expected, b, std::memory_order_relaxed))
+                    return;
+            }
+        }
+
+    private:
+        std::vector<std::atomic<int> > m_parents;
+    };
+} // exercise::one
+
+#endif //UNION_FIND_H
@@ -0,0 +1,425 @@
+//
+// Created by Jost on 17/10/2026.
+//
+
+#include "cch_graph.h"
+
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+#include <limits>
+
+#include "csr_builder.h"
+#include "thread_pool.h"
+
+namespace exercise::two {
+    // half the range, so adding two weights of missing arcs can't overflow
+    constexpr int NO_ARC_WEIGHT = std::numeric_limits<int>::max() / 2;
+
+    /// Undirected graph without loops and parallel edges in CSR layout
+    struct UndirectedGraph {
+        std::vector<int> offsets;
+        std::vector<int> neighbours;
+    };
+
+    static UndirectedGraph build_undirected_graph(const int node_count, const std::vector<FMIEdge> &edges) {
+        std::vector<std::pair<int, int> > pairs;
+        pairs.reserve(edges.size() * 2);
+        for (const auto &[from, to, _]: edges) {
+            if (from != to) {
+                pairs.emplace_back(from, to);
+                pairs.emplace_back(to, from);
+            }
+        }
+
+        UndirectedGraph graph;
+        build_csr(pairs, node_count, graph.offsets, graph.neighbours,
+                  [](const std::pair<int, int> &pair) { return pair.first; },
+                  [](const std::pair<int, int> &pair) { return pair.second; }, 1);
+
+        // both directions of a road and parallel edges become one neighbour
+        int head = 0;
+        for (int node = 0; node < node_count; ++node) {
+            const auto first = graph.neighbours.begin() + graph.offsets[node];
+            const auto last = graph.neighbours.begin() + graph.offsets[node + 1];
+            std::sort(first, last);
+            const auto unique_last = std::unique(first, last);
+            graph.offsets[node] = head;
+            head = static_cast<int>(std::copy(first, unique_last, graph.neighbours.begin() + head)
+                                    - graph.neighbours.begin());
+        }
+        graph.offsets[node_count] = head;
+        graph.neighbours.resize(head);
+        return graph;
+    }
+
+    /// Nested dissection: a part that is connected is split by the smallest BFS layer that leaves at least a third
+    /// of the part on both sides, the layer separates the layers before it from the ones after it. The separator
+    /// gets the highest ranks of the part, both sides are ordered the same way below it. Parts with less than three
+    /// layers are ranked in BFS order
+    static std::vector<int> compute_nested_dissection_ranks(const UndirectedGraph &graph) {
+        const auto node_count = static_cast<int>(graph.offsets.size()) - 1;
+
+        struct Part {
+            int id;
+            int first_rank;
+            std::vector<int> nodes;
+        };
+
+        std::vector<int> ranks(node_count, -1);
+        std::vector<int> part_ids(node_count, 0);
+        std::vector<int> depths(node_count, -1);
+        int next_part_id = 1;
+
+        std::vector<Part> parts;
+        if (node_count > 0) {
+            std::vector<int> all_nodes(node_count);
+            for (int node = 0; node < node_count; ++node) {
+                all_nodes[node] = node;
+            }
+            parts.push_back(Part{0, 0, std::move(all_nodes)});
+        }
+
+        // BFS inside the part, appends the reached nodes to the order and sets their depths
+        std::vector<int> order;
+        const auto run_bfs = [&](const int part_id, const int start) {
+            const auto first = order.size();
+            order.push_back(start);
+            depths[start] = 0;
+            for (auto i = first; i < order.size(); ++i) {
+                const auto node = order[i];
+                for (int j = graph.offsets[node]; j < graph.offsets[node + 1]; ++j) {
+                    const auto neighbour = graph.neighbours[j];
+                    if (part_ids[neighbour] == part_id && depths[neighbour] == -1) {
+                        depths[neighbour] = depths[node] + 1;
+                        order.push_back(neighbour);
+                    }
+                }
+            }
+        };
+        const auto clear_order = [&]() {
+            for (const auto node: order) {
+                depths[node] = -1;
+            }
+            order.clear();
+        };
+        const auto push_part = [&](std::vector<int> nodes, const int first_rank) {
+            const auto id = next_part_id++;
+            for (const auto node: nodes) {
+                part_ids[node] = id;
+            }
+            parts.push_back(Part{id, first_rank, std::move(nodes)});
+        };
+
+        while (!parts.empty()) {
+            auto part = std::move(parts.back());
+            parts.pop_back();
+
+            run_bfs(part.id, part.nodes.front());
+            if (order.size() < part.nodes.size()) {
+                // the part falls apart, every component is ordered on its own without a separator
+                std::vector<size_t> component_ends{order.size()};
+                for (const auto node: part.nodes) {
+                    if (depths[node] == -1) {
+                        run_bfs(part.id, node);
+                        component_ends.push_back(order.size());
+                    }
+                }
+                size_t component_begin = 0;
+                for (const auto component_end: component_ends) {
+                    push_part(std::vector<int>(order.begin() + static_cast<long long>(component_begin),
+                                               order.begin() + static_cast<long long>(component_end)),
+                              part.first_rank + static_cast<int>(component_begin));
+                    component_begin = component_end;
+                }
+                clear_order();
+                continue;
+            }
+
+            // the second BFS starts at a node far away from the first start, so the layers get thin
+            const auto far_node = order.back();
+            clear_order();
+            run_bfs(part.id, far_node);
+            const auto layer_count = depths[order.back()] + 1;
+
+            if (layer_count < 3) {
+                for (int i = 0; i < static_cast<int>(order.size()); ++i) {
+                    ranks[order[i]] = part.first_rank + i;
+                }
+                clear_order();
+                continue;
+            }
+
+            std::vector<int> layer_sizes(layer_count, 0);
+            for (const auto node: order) {
+                layer_sizes[depths[node]]++;
+            }
+            const auto size = static_cast<int>(order.size());
+            auto separator_layer = -1;
+            for (int layer = 1, before = layer_sizes[0]; layer < layer_count - 1; before += layer_sizes[layer++]) {
+                const auto after = size - before - layer_sizes[layer];
+                if (3 * before < size || 3 * after < size)
+                    continue;
+                if (separator_layer == -1 || layer_sizes[layer] < layer_sizes[separator_layer]) {
+                    separator_layer = layer;
+                }
+            }
+            // no layer is balanced enough, the middle one still splits the part
+            if (separator_layer == -1) {
+                separator_layer = layer_count / 2;
+            }
+
+            std::vector<int> near_nodes;
+            std::vector<int> far_nodes;
+            auto separator_rank = part.first_rank + size - layer_sizes[separator_layer];
+            for (const auto node: order) {
+                if (depths[node] < separator_layer) {
+                    near_nodes.push_back(node);
+                } else if (depths[node] > separator_layer) {
+                    far_nodes.push_back(node);
+                } else {
+                    ranks[node] = separator_rank++;
+                }
+            }
+            clear_order();
+
+            const auto near_count = static_cast<int>(near_nodes.size());
+            push_part(std::move(near_nodes), part.first_rank);
+            push_part(std::move(far_nodes), part.first_rank + near_count);
+        }
+
+        return ranks;
+    }
+
+    CCHGraph::CCHGraph(std::fstream input_file, const int thread_count) {
+        std::vector<FMIEdge> edges;
+        const auto node_count = parse_fmi_file(std::move(input_file), edges);
+        build(node_count, edges);
+
+        std::vector<int> weights(edges.size());
+        for (size_t i = 0; i < edges.size(); ++i) {
+            weights[i] = edges[i].weight;
+        }
+        customize(weights, thread_count);
+    }
+
+    CCHGraph::CCHGraph(const int node_count, const std::vector<FMIEdge> &edges, const int thread_count) {
+        build(node_count, edges);
+
+        std::vector<int> weights(edges.size());
+        for (size_t i = 0; i < edges.size(); ++i) {
+            weights[i] = edges[i].weight;
+        }
+        customize(weights, thread_count);
+    }
+
+    void CCHGraph::build(const int node_count, const std::vector<FMIEdge> &edges) {
+        std::cout << "[Info] Computing nested dissection order for CCH" << std::endl;
+        const auto graph = build_undirected_graph(node_count, edges);
+        m_ranks = compute_nested_dissection_ranks(graph);
+
+        // contraction in rank order, the upper neighbours of a node are added to the upper neighbours of its
+        // lowest upper neighbour, which is enough to make all of them a clique
+        std::cout << "[Info] Contracting " << node_count << " nodes in nested dissection order" << std::endl;
+        std::vector<std::vector<int> > upper_neighbours(node_count);
+        for (int node = 0; node < node_count; ++node) {
+            const auto rank = m_ranks[node];
+            for (int i = graph.offsets[node]; i < graph.offsets[node + 1]; ++i) {
+                if (const auto neighbour_rank = m_ranks[graph.neighbours[i]]; neighbour_rank > rank) {
+                    upper_neighbours[rank].push_back(neighbour_rank);
+                }
+            }
+        }
+        for (auto &neighbours: upper_neighbours) {
+            std::sort(neighbours.begin(), neighbours.end());
+        }
+        m_parents.assign(node_count, -1);
+        std::vector<int> merged;
+        for (int rank = 0; rank < node_count; ++rank) {
+            const auto &neighbours = upper_neighbours[rank];
+            if (neighbours.empty())
+                continue;
+
+            const auto parent = neighbours.front();
+            m_parents[rank] = parent;
+            auto &parent_neighbours = upper_neighbours[parent];
+            merged.clear();
+            std::set_union(parent_neighbours.begin(), parent_neighbours.end(), neighbours.begin() + 1,
+                           neighbours.end(), std::back_inserter(merged));
+            parent_neighbours.swap(merged);
+        }
+
+        m_up_offsets.assign(node_count + 1, 0);
+        for (int rank = 0; rank < node_count; ++rank) {
+            m_up_offsets[rank + 1] = m_up_offsets[rank] + static_cast<int>(upper_neighbours[rank].size());
+        }
+        m_up_heads.resize(m_up_offsets[node_count]);
+        for (int rank = 0; rank < node_count; ++rank) {
+            std::copy(upper_neighbours[rank].begin(), upper_neighbours[rank].end(),
+                      m_up_heads.begin() + m_up_offsets[rank]);
+            upper_neighbours[rank] = std::vector<int>();
+        }
+        m_up_weights.assign(m_up_heads.size(), NO_ARC_WEIGHT);
+        m_down_weights.assign(m_up_heads.size(), NO_ARC_WEIGHT);
+
+        // the customization of a node pulls the weights over its lower neighbours
+        std::vector<std::pair<int, LowerArc> > lower_arcs;
+        lower_arcs.reserve(m_up_heads.size());
+        for (int rank = 0; rank < node_count; ++rank) {
+            for (int arc = m_up_offsets[rank]; arc < m_up_offsets[rank + 1]; ++arc) {
+                lower_arcs.emplace_back(m_up_heads[arc], LowerArc{rank, arc});
+            }
+        }
+        build_csr(lower_arcs, node_count, m_lower_offsets, m_lower_arcs,
+                  [](const std::pair<int, LowerArc> &arc) { return arc.first; },
+                  [](const std::pair<int, LowerArc> &arc) { return arc.second; }, 1);
+
+        // a node only depends on its descendants, which all have a lower height in the elimination tree
+        std::vector<int> heights(node_count, 0);
+        for (int rank = 0; rank < node_count; ++rank) {
+            if (m_parents[rank] != -1) {
+                heights[m_parents[rank]] = std::max(heights[m_parents[rank]], heights[rank] + 1);
+            }
+        }
+        std::vector<int> ranks_by_height(node_count);
+        for (int rank = 0; rank < node_count; ++rank) {
+            ranks_by_height[rank] = rank;
+        }
+        const auto level_count = node_count == 0 ? 0 : *std::max_element(heights.begin(), heights.end()) + 1;
+        build_csr(ranks_by_height, level_count, m_level_offsets, m_level_nodes,
+                  [&heights](const int rank) { return heights[rank]; },
+                  [](const int rank) { return rank; }, 1);
+
+        // the arc of an input edge is found by a binary search in the sorted arcs of its lower end
+        m_input_arcs.resize(edges.size());
+        for (size_t i = 0; i < edges.size(); ++i) {
+            const auto from = m_ranks[edges[i].from];
+            const auto to = m_ranks[edges[i].to];
+            if (from == to) {
+                m_input_arcs[i] = InputArc{-1, true};
+                continue;
+            }
+
+            const auto tail = std::min(from, to);
+            const auto head = std::max(from, to);
+            const auto first = m_up_heads.begin() + m_up_offsets[tail];
+            const auto last = m_up_heads.begin() + m_up_offsets[tail + 1];
+            const auto arc = static_cast<int>(std::lower_bound(first, last, head) - m_up_heads.begin());
+            m_input_arcs[i] = InputArc{arc, from < to};
+        }
+    }
+
+    bool CCHGraph::customize(const std::vector<int> &weights, const int thread_count) {
+        if (weights.size() != m_input_arcs.size())
+            return false;
+
+        std::fill(m_up_weights.begin(), m_up_weights.end(), NO_ARC_WEIGHT);
+        std::fill(m_down_weights.begin(), m_down_weights.end(), NO_ARC_WEIGHT);
+        for (size_t i = 0; i < weights.size(); ++i) {
+            const auto [arc, upward] = m_input_arcs[i];
+            if (arc == -1)
+                continue;
+
+            auto &weight = upward ? m_up_weights[arc] : m_down_weights[arc];
+            weight = std::min(weight, weights[i]);
+        }
+
+        // every lower triangle v < u < w of an arc u -> w offers the path u -> v -> w and for the reverse arc
+        // the path w -> v -> u. The arcs of v are final, because v is a descendant of u in the elimination tree
+        const auto node_count = get_node_count();
+        WorkStealingPool pool(thread_count);
+        std::vector<std::vector<int> > arcs_by_head(pool.get_thread_count(), std::vector<int>(node_count, -1));
+        for (int level = 0; level + 1 < static_cast<int>(m_level_offsets.size()); ++level) {
+            const auto level_begin = m_level_offsets[level];
+            pool.parallel_for(m_level_offsets[level + 1] - level_begin, [&](const int thread_index, const int item) {
+                const auto node = m_level_nodes[level_begin + item];
+                auto &arc_of = arcs_by_head[thread_index];
+                for (int arc = m_up_offsets[node]; arc < m_up_offsets[node + 1]; ++arc) {
+                    arc_of[m_up_heads[arc]] = arc;
+                }
+
+                for (int i = m_lower_offsets[node]; i < m_lower_offsets[node + 1]; ++i) {
+                    const auto [lower_node, lower_arc] = m_lower_arcs[i];
+                    const auto to_lower = m_down_weights[lower_arc];
+                    const auto from_lower = m_up_weights[lower_arc];
+
+                    // the arcs of the lower node are sorted, so all after the one to this node lead higher
+                    for (int arc = lower_arc + 1; arc < m_up_offsets[lower_node + 1]; ++arc) {
+                        const auto upper_arc = arc_of[m_up_heads[arc]];
+                        m_up_weights[upper_arc] = std::min(m_up_weights[upper_arc], to_lower + m_up_weights[arc]);
+                        m_down_weights[upper_arc] = std::min(m_down_weights[upper_arc],
+                                                             m_down_weights[arc] + from_lower);
+                    }
+                }
+
+                for (int arc = m_up_offsets[node]; arc < m_up_offsets[node + 1]; ++arc) {
+                    arc_of[m_up_heads[arc]] = -1;
+                }
+            });
+        }
+        return true;
+    }
+
+    int CCHGraph::compute_shortest_path(const int source, const int target) const {
+        const auto node_count = get_node_count();
+        if (source < 0 || source >= node_count || target < 0 || target >= node_count)
+            return -1;
+
+        // every thread keeps its distance arrays, a query only resets the ancestors it touched
+        thread_local std::vector<int> forward_distances;
+        thread_local std::vector<int> backward_distances;
+        if (static_cast<int>(forward_distances.size()) < node_count) {
+            forward_distances.assign(node_count, NO_ARC_WEIGHT);
+            backward_distances.assign(node_count, NO_ARC_WEIGHT);
+        }
+
+        // all upper neighbours of a node are ancestors in the elimination tree, so each search only touches the
+        // path from its start to the root and visits it in ascending rank order
+        const auto search = [this](const int start, const std::vector<int> &weights, std::vector<int> &distances) {
+            distances[start] = 0;
+            for (auto node = start; node != -1; node = m_parents[node]) {
+                const auto distance = distances[node];
+                if (distance == NO_ARC_WEIGHT)
+                    continue;
+
+                for (int arc = m_up_offsets[node]; arc < m_up_offsets[node + 1]; ++arc) {
+                    auto &head_distance = distances[m_up_heads[arc]];
+                    head_distance = std::min(head_distance, distance + weights[arc]);
+                }
+            }
+        };
+        const auto forward_start = m_ranks[source];
+        const auto backward_start = m_ranks[target];
+        search(forward_start, m_up_weights, forward_distances);
+        search(backward_start, m_down_weights, backward_distances);
+
+        // the shortest path meets at a common ancestor, which are the only nodes with both distances
+        auto shortest_distance = NO_ARC_WEIGHT;
+        for (auto node = forward_start; node != -1; node = m_parents[node]) {
+            shortest_distance = std::min(shortest_distance, forward_distances[node] + backward_distances[node]);
+        }
+        for (auto node = forward_start; node != -1; node = m_parents[node]) {
+            forward_distances[node] = NO_ARC_WEIGHT;
+        }
+        for (auto node = backward_start; node != -1; node = m_parents[node]) {
+            backward_distances[node] = NO_ARC_WEIGHT;
+        }
+
+        if (shortest_distance >= NO_ARC_WEIGHT)
+            return -1;
+
+        return shortest_distance;
+    }
+
+    int CCHGraph::get_node_count() const {
+        return static_cast<int>(m_ranks.size());
+    }
+
+    int CCHGraph::get_arc_count() const {
+        return static_cast<int>(m_up_heads.size());
+    }
+
+    int CCHGraph::get_elimination_tree_height() const {
+        return static_cast<int>(m_level_offsets.size()) - 1;
+    }
+} // exercise::two
@@ -0,0 +1,90 @@
+//
+// Created by Jost on 17/10/2026.
+//
+
+#ifndef CCH_GRAPH_H
+#define CCH_GRAPH_H
+
+#include <fstream>
+#include <thread>
+#include <vector>
+
+#include "parse_fmi_graph_file.h"
+
+namespace exercise::two {
+    /// Customizable contraction hierarchy. The node order and the shortcuts only depend on the structure of the
+    /// graph and are computed once, a new set of edge weights is then applied by the customization alone:
+    ///  1. nested dissection order, BFS layers of the remaining graph serve as separators, which get the highest
+    ///     ranks of their part
+    ///  2. contraction without witness searches, all upper neighbours of a node become a clique, the first upper
+    ///     neighbour is the parent of the node in the elimination tree
+    ///  3. customization, the weights of the upward arcs of a node only depend on the arcs of lower nodes, so the
+    ///     nodes of one elimination tree level are customized in parallel
+    /// A query relaxes the upward arcs of all ancestors of source and target, there is no priority queue.
+    class CCHGraph {
+    public:
+        /// Reads the fmi file, builds the metric independent part and customizes it with the weights of the file
+        explicit CCHGraph(std::fstream input_file,
+                          int thread_count = static_cast<int>(std::thread::hardware_concurrency()));
+
+        /// The weights of the edges are only used for the first customization
+        CCHGraph(int node_count, const std::vector<FMIEdge> &edges,
+                 int thread_count = static_cast<int>(std::thread::hardware_concurrency()));
+
+        /// Recomputes all arc weights, weights[i] is the new weight of the i-th edge the graph was built from.
+        /// Returns false and keeps the current weights if the number of weights doesn't match
+        bool customize(const std::vector<int> &weights,
+                       int thread_count = static_cast<int>(std::thread::hardware_concurrency()));
+
+        /// Distance from source to target with the last customized weights, -1 if there is no path
+        [[nodiscard]] int compute_shortest_path(int source, int target) const;
+
+        [[nodiscard]] int get_node_count() const;
+
+        /// Arcs between a node and its upper neighbours including the shortcuts, each one stores both directions
+        [[nodiscard]] int get_arc_count() const;
+
+        /// Number of nodes on the longest path from a node to its elimination tree root, which bounds the nodes a
+        /// query has to scan from each side
+        [[nodiscard]] int get_elimination_tree_height() const;
+
+    private:
+        /// Arc from a lower neighbour to the node
+        struct LowerArc {
+            int tail;
+            int arc;
+        };
+
+        /// Arc of an input edge, the edge goes upwards if its source has the lower rank
+        struct InputArc {
+            int arc;
+            bool upward;
+        };
+
+        // nodes are indexed by their rank
+        std::vector<int> m_ranks;
+
+        // upward arcs by tail, sorted by head
+        std::vector<int> m_up_offsets;
+        std::vector<int> m_up_heads;
+        // weight of tail -> head and head -> tail
+        std::vector<int> m_up_weights;
+        std::vector<int> m_down_weights;
+
+        std::vector<int> m_lower_offsets;
+        std::vector<LowerArc> m_lower_arcs;
+
+        // elimination tree, -1 for the roots
+        std::vector<int> m_parents;
+        // nodes grouped by their height in the elimination tree, the leaves first
+        std::vector<int> m_level_offsets;
+        std::vector<int> m_level_nodes;
+
+        // -1 as arc for loops
+        std::vector<InputArc> m_input_arcs;
+
+        void build(int node_count, const std::vector<FMIEdge> &edges);
+    };
+} // exercise::two
+
+#endif //CCH_GRAPH_H
@@ -4,36 +4,299 @@
 
 #include "ch_graph.h"
 #include <algorithm>
-#include <array>
+#include <atomic>
+#include <charconv>
 #include <cmath>
-#include <future>
 #include <iostream>
 #include <limits>
-#include <list>
+#include <numeric>
 #include <queue>
 #include <thread>
 #include <unordered_set>
 
+#include "contraction_graph.h"
+#include "csr_builder.h"
 #include "parse_ch_graph_file.h"
 #include "parse_fmi_graph_file.h"
-#include "progressive_dijkstra.h"
+#include "snapshot.h"
+#include "thread_pool.h"
+#include "witness_search.h"
 
 namespace exercise::two {
-    CHGraph::CHGraph(std::fstream input_file, const bool is_ch_graph) {
+    CHGraph::CHGraph(std::fstream input_file, const bool is_ch_graph, const CHPreprocessingOptions &options) {
         if (is_ch_graph) {
             read_in_ch_graph(std::move(input_file));
         } else {
-            generate_ch_graph(std::move(input_file));
+            generate_ch_graph(std::move(input_file), options);
         }
     }
 
-    int CHGraph::compute_shortest_path(int source, int target) const {
-        struct SPNode {
-            int index;
-            int distance;
-            bool is_up_node;
+    constexpr char CH_GRAPH_SNAPSHOT_MAGIC[8] = {'C', 'H', 'G', 'R', 'A', 'P', 'H', '\0'};
+    // increase whenever the stored arrays change
+    constexpr uint32_t CH_GRAPH_SNAPSHOT_VERSION = 3;
+
+    bool CHGraph::save(const std::string &file_name) const {
+        SnapshotWriter writer(file_name, CH_GRAPH_SNAPSHOT_MAGIC, CH_GRAPH_SNAPSHOT_VERSION);
+        writer.write_array(m_node_index_map);
+        writer.write_array(m_node_ids);
+        m_edges.save(writer);
+        return writer.finish();
+    }
+
+    std::optional<CHGraph> CHGraph::from_snapshot(const std::string &file_name) {
+        SnapshotReader reader(file_name, CH_GRAPH_SNAPSHOT_MAGIC, CH_GRAPH_SNAPSHOT_VERSION);
+
+        CHGraph graph;
+        if (!reader.read_array(graph.m_node_index_map) || !reader.read_array(graph.m_node_ids)
+            || !graph.m_edges.load(reader) || graph.m_edges.get_node_count() != graph.get_node_count()) {
+            return std::nullopt;
+        }
+
+        return graph;
+    }
+
+    std::optional<CHGraph> CHGraph::from_ch_file(const std::string &file_name, const int thread_count) {
+        std::vector<CHNode> nodes;
+        std::vector<CHEdge> edges;
+        if (parse_ch_file(file_name, nodes, edges, thread_count) == -1)
+            return std::nullopt;
+
+        CHGraph graph;
+        graph.build_query_graph(std::move(nodes), edges);
+        return graph;
+    }
+
+    // nodes formatted by one thread before the blocks of a round are written
+    constexpr int CH_WRITE_BLOCK_NODES = 1 << 15;
+
+    static void append_number(std::string &buffer, const int value) {
+        char digits[16];
+        const auto end = std::to_chars(digits, digits + sizeof(digits), value).ptr;
+        buffer.append(digits, end);
+    }
+
+    bool CHGraph::save_ch(const std::string &file_name, int thread_count) const {
+        const auto node_count = get_node_count();
+        thread_count = std::max(1, thread_count);
+
+        // edges between nodes of the same level are stored at both ends, so an edge to a node with a larger index
+        // links two nodes of the same level. Linked nodes get the level of the one with the smallest index, which
+        // keeps the order of all other adjacent nodes
+        std::vector<int> level_roots(node_count);
+        std::iota(level_roots.begin(), level_roots.end(), 0);
+        const auto find_root = [&level_roots](int node) {
+            while (level_roots[node] != node) {
+                level_roots[node] = level_roots[level_roots[node]];
+                node = level_roots[node];
+            }
+            return node;
+        };
+        for (int node = 0; node < node_count; ++node) {
+            for (auto position = m_edges.begin(node); position < m_edges.end(node); ++position) {
+                if (const auto neighbour = m_edges.get_edge(node, position).to; neighbour > node) {
+                    const auto root = find_root(node);
+                    const auto neighbour_root = find_root(neighbour);
+                    level_roots[std::max(root, neighbour_root)] = std::min(root, neighbour_root);
+                }
+            }
+        }
+        for (int node = 0; node < node_count; ++node) {
+            level_roots[node] = find_root(node);
+        }
+
+        // of the two entries of an edge between nodes of the same level only the up entry is written
+        const auto is_written = [this, &level_roots](const int node, const int position, const uint32_t direction) {
+            return (m_edges.get_directions(position) & direction)
+                   && (direction == PackedCHEdges::UP
+                       || level_roots[m_edges.get_edge(node, position).to] != level_roots[node]);
+        };
+
+        // index of the first written edge of every node
+        std::vector<long long> first_edges(node_count + 1, 0);
+        parallel_for_chunks(node_count, thread_count, [&](const size_t begin, const size_t end) {
+            for (auto node = static_cast<int>(begin); node < static_cast<int>(end); ++node) {
+                for (auto position = m_edges.begin(node); position < m_edges.end(node); ++position) {
+                    first_edges[node + 1] += is_written(node, position, PackedCHEdges::UP)
+                            + is_written(node, position, PackedCHEdges::DOWN);
+                }
+            }
+        });
+        for (int node = 0; node < node_count; ++node) {
+            first_edges[node + 1] += first_edges[node];
+        }
+        if (first_edges[node_count] > std::numeric_limits<int>::max())
+            return false;
+
+        // the children of a shortcut from -> to are the edges from -> middle and middle -> to, both stored at the
+        // lower middle node, their weights add up to the one of the shortcut
+        const auto find_child_edges = [&](const int from, const int to, const int weight, const int middle) {
+            auto in_index = first_edges[middle];
+            for (auto in_position = m_edges.begin(middle); in_position < m_edges.end(middle); ++in_position) {
+                in_index += is_written(middle, in_position, PackedCHEdges::UP);
+                if (!is_written(middle, in_position, PackedCHEdges::DOWN))
+                    continue;
+
+                const auto in_edge = m_edges.get_edge(middle, in_position);
+                if (in_edge.to == from) {
+                    auto out_index = first_edges[middle];
+                    for (auto out_position = m_edges.begin(middle); out_position < m_edges.end(middle);
+                         ++out_position) {
+                        const auto out_edge = m_edges.get_edge(middle, out_position);
+                        if (is_written(middle, out_position, PackedCHEdges::UP) && out_edge.to == to
+                            && in_edge.weight + out_edge.weight == weight) {
+                            return std::pair{in_index, out_index};
+                        }
+                        out_index += is_written(middle, out_position, PackedCHEdges::UP)
+                                + is_written(middle, out_position, PackedCHEdges::DOWN);
+                    }
+                }
+                in_index++;
+            }
+            return std::pair{-1LL, -1LL};
+        };
+
+        const auto format_edge = [&](std::string &buffer, const int from, const int to, const int weight,
+                                     const int middle) {
+            const auto [first_child, second_child] = middle == -1
+                                                         ? std::pair{-1LL, -1LL}
+                                                         : find_child_edges(from, to, weight, middle);
+            append_number(buffer, m_node_ids[from]);
+            buffer += ' ';
+            append_number(buffer, m_node_ids[to]);
+            buffer += ' ';
+            append_number(buffer, weight);
+            // type and max speed aren't kept
+            buffer += " 0 0 ";
+            append_number(buffer, static_cast<int>(first_child));
+            buffer += ' ';
+            append_number(buffer, static_cast<int>(second_child));
+            buffer += '\n';
+        };
+
+        std::ofstream file(file_name, std::ios::out | std::ios::binary | std::ios::trunc);
+        file << "# contraction hierarchy, coordinates aren't stored\n\n" << node_count << '\n'
+                << first_edges[node_count] << '\n';
+
+        // every round formats one block of nodes per thread and writes the blocks in order, so the text of the
+        // whole file is never in memory at once
+        std::vector<std::string> blocks(thread_count);
+        const auto write_blocks = [&](const auto &format_node) {
+            const auto round_size = static_cast<long long>(thread_count) * CH_WRITE_BLOCK_NODES;
+            for (long long round_begin = 0; round_begin < node_count; round_begin += round_size) {
+                parallel_for_chunks(thread_count, thread_count, [&](const size_t block, size_t) {
+                    blocks[block].clear();
+                    const auto first = std::min<long long>(node_count, round_begin + block * CH_WRITE_BLOCK_NODES);
+                    const auto last = std::min<long long>(node_count, first + CH_WRITE_BLOCK_NODES);
+                    for (auto node = static_cast<int>(first); node < static_cast<int>(last); ++node) {
+                        format_node(blocks[block], node);
+                    }
+                });
+                for (const auto &block: blocks) {
+                    file.write(block.data(), static_cast<std::streamsize>(block.size()));
+                }
+            }
+        };
+
+        // nodes by id, the level is the inverted index of the first node of the same level
+        write_blocks([&](std::string &buffer, const int id) {
+            append_number(buffer, id);
+            buffer += " 0 0 0 0 ";
+            append_number(buffer, node_count - 1 - level_roots[m_node_index_map[id]]);
+            buffer += '\n';
+        });
+        write_blocks([&](std::string &buffer, const int node) {
+            for (auto position = m_edges.begin(node); position < m_edges.end(node); ++position) {
+                const auto [neighbour, weight] = m_edges.get_edge(node, position);
+                const auto middle = m_edges.get_middle_node(position);
+                if (is_written(node, position, PackedCHEdges::UP)) {
+                    format_edge(buffer, node, neighbour, weight, middle);
+                }
+                if (is_written(node, position, PackedCHEdges::DOWN)) {
+                    format_edge(buffer, neighbour, node, weight, middle);
+                }
+            }
+        });
+
+        file.close();
+        return !file.fail();
+    }
+
+    int CHGraph::compute_shortest_path(const int source, const int target) const {
+        // every thread keeps one workspace, so repeated queries don't allocate and clear the distance arrays
+        thread_local CHQueryWorkspace<> workspace;
+        return compute_shortest_path(source, target, workspace);
+    }
+
+    /// One direction of the CH query, the forward search runs on the up edges and is stalled over the down edges,
+    /// the backward search the other way around
+    template<typename Queue>
+    struct CHSearchDirection {
+        const PackedCHEdges &edges;
+        uint32_t direction;
+        uint32_t stall_direction;
+        TimestampedDistances &distances;
+        const TimestampedDistances &opposite_distances;
+        std::vector<ParentEdge> &parents;
+        Queue &queue;
+        bool active = true;
+    };
+
+    /// Settles the next node of the direction, which becomes inactive once it can't find a shorter path anymore
+    template<typename Queue>
+    static void settle_next_node(CHSearchDirection<Queue> &direction, CHQueryWorkspace<Queue> &workspace,
+                                 int &valid_min_distance, const bool stall_on_demand) {
+        if (direction.queue.empty()) {
+            direction.active = false;
+            return;
+        }
+
+        const auto [index, distance] = direction.queue.pop();
+
+        // old invalid entry, not removed for performance
+        if (distance > direction.distances.get(index)) {
+            return;
+        }
+
+        // all remaining nodes of this direction are at least as far away as the shortest path found
+        if (distance >= valid_min_distance) {
+            direction.active = false;
+            return;
+        }
+
+        // check if possible shortest is path found
+        if (const auto opposite_distance = direction.opposite_distances.get(index);
+            opposite_distance != TimestampedDistances::INFINITE_DISTANCE
+            && distance + opposite_distance < valid_min_distance) {
+            valid_min_distance = distance + opposite_distance;
+            workspace.meeting_node = index;
+        }
+
+        // a higher node reaches this node on a shorter path, so no shortest path continues over its edges
+        const auto is_reached_shorter = [&direction, distance](const Edge edge) {
+            const auto higher_distance = direction.distances.get(edge.to);
+            return higher_distance != TimestampedDistances::INFINITE_DISTANCE
+                   && higher_distance + edge.weight < distance;
         };
+        if (stall_on_demand && direction.edges.any_edge(index, direction.stall_direction, is_reached_shorter)) {
+            workspace.stalled_nodes++;
+            return;
+        }
+        workspace.settled_nodes++;
+
+        direction.edges.for_each_edge(index, direction.direction, [&](const int position, const Edge edge) {
+            const auto [neighbour_index, weight] = edge;
+            if (const auto new_distance = distance + weight;
+                new_distance < direction.distances.get(neighbour_index)) {
+                direction.distances.set(neighbour_index, new_distance);
+                direction.parents[neighbour_index] = ParentEdge{index, position};
+                direction.queue.push(neighbour_index, new_distance);
+            }
+        });
+    }
 
+    template<typename Queue>
+    int CHGraph::compute_shortest_path(int source, int target, CHQueryWorkspace<Queue> &workspace,
+                                       const bool stall_on_demand) const {
         // invalid node index
         if (source >= m_node_index_map.size() || target >= m_node_index_map.size()) {
             return -1;
@@ -44,67 +307,124 @@ namespace exercise::two {
 
         int valid_min_distance = std::numeric_limits<int>::max();
 
-        std::vector<int> up_distances;
-        std::vector<int> down_distances;
-        up_distances.resize(m_node_index_map.size(), std::numeric_limits<int>::max());
-        down_distances.resize(m_node_index_map.size(), std::numeric_limits<int>::max());
+        workspace.reset(static_cast<int>(m_node_index_map.size()));
+        CHSearchDirection<Queue> forward{
+            m_edges, PackedCHEdges::UP, PackedCHEdges::DOWN,
+            workspace.up_distances, workspace.down_distances, workspace.up_parents, workspace.up_queue
+        };
+        CHSearchDirection<Queue> backward{
+            m_edges, PackedCHEdges::DOWN, PackedCHEdges::UP,
+            workspace.down_distances, workspace.up_distances, workspace.down_parents, workspace.down_queue
+        };
 
-        // creates a min priority queue ordered by distance
-        auto cmp = [](const SPNode &left, const SPNode &right) { return left.distance > right.distance; };
-        std::priority_queue<SPNode, std::vector<SPNode>, decltype(cmp)> queue(cmp);
+        forward.distances.set(source, 0);
+        forward.queue.push(source, 0);
+        backward.distances.set(target, 0);
+        backward.queue.push(target, 0);
+
+        // the directions take turns until neither can find a shorter path
+        bool forward_turn = true;
+        while (forward.active || backward.active) {
+            auto &direction = (forward_turn && forward.active) || !backward.active ? forward : backward;
+            forward_turn = !forward_turn;
+            settle_next_node(direction, workspace, valid_min_distance, stall_on_demand);
+        }
 
-        up_distances[source] = 0;
-        queue.push(SPNode{source, 0, true});
-        down_distances[target] = 0;
-        queue.push(SPNode{target, 0, false});
+        // no path exists return an invalid distance
+        if (valid_min_distance == std::numeric_limits<int>::max())
+            return -1;
 
-        while (!queue.empty()) {
-            const auto [index, distance, is_up_node] = queue.top();
-            queue.pop();
+        return valid_min_distance;
+    }
 
-            if (is_up_node) {
-                // old invalid entry, not removed for performance
-                if (distance > up_distances[index]) {
-                    continue;
-                }
+    template int CHGraph::compute_shortest_path(int, int, CHQueryWorkspace<BinaryHeap> &, bool) const;
+    template int CHGraph::compute_shortest_path(int, int, CHQueryWorkspace<QuaternaryHeap> &, bool) const;
+    template int CHGraph::compute_shortest_path(int, int, CHQueryWorkspace<RadixHeap> &, bool) const;
 
-                // check if possible shortest is path found
-                if (down_distances[index] != std::numeric_limits<int>::max()) {
-                    valid_min_distance = std::min(valid_min_distance, distance + down_distances[index]);
-                }
-            } else {
-                // old invalid entry, not removed for performance
-                if (distance > down_distances[index]) {
-                    continue;
-                }
+    /// Complete upward search of one direction of the parallel query, it only touches the memory of its own direction
+    template<typename Queue>
+    static void run_parallel_query_direction(const int start, CHSearchDirection<Queue> &direction,
+                                             std::vector<int> &settled_nodes, int &stalled_nodes) {
+        direction.distances.set(start, 0);
+        direction.queue.push(start, 0);
 
-                // check if possible shortest is path found
-                if (up_distances[index] != std::numeric_limits<int>::max()) {
-                    valid_min_distance = std::min(valid_min_distance, distance + up_distances[index]);
-                }
-            }
+        while (!direction.queue.empty()) {
+            const auto [index, distance] = direction.queue.pop();
 
-            // no more possible expansions shorter than shortest found valid path -> found the shortest path
-            if (distance > valid_min_distance) {
-                break;
+            // old invalid entry, not removed for performance
+            if (distance > direction.distances.get(index)) {
+                continue;
             }
 
-            if (is_up_node) {
-                for (int i = m_up_edges_offsets[index]; i < m_up_edges_offsets[index + 1]; ++i) {
-                    const auto [neighbour_index, weight] = m_up_edges[i];
-                    if (const auto new_distance = distance + weight; new_distance < up_distances[neighbour_index]) {
-                        up_distances[neighbour_index] = new_distance;
-                        queue.push(SPNode{neighbour_index, new_distance, true});
-                    }
+            // a higher node reaches this node on a shorter path, so no shortest path continues over its edges
+            const auto is_reached_shorter = [&direction, distance](const Edge edge) {
+                const auto higher_distance = direction.distances.get(edge.to);
+                return higher_distance != TimestampedDistances::INFINITE_DISTANCE
+                       && higher_distance + edge.weight < distance;
+            };
+            if (direction.edges.any_edge(index, direction.stall_direction, is_reached_shorter)) {
+                stalled_nodes++;
+                continue;
+            }
+            settled_nodes.push_back(index);
+
+            direction.edges.for_each_edge(index, direction.direction, [&](const int position, const Edge edge) {
+                const auto [neighbour_index, weight] = edge;
+                if (const auto new_distance = distance + weight;
+                    new_distance < direction.distances.get(neighbour_index)) {
+                    direction.distances.set(neighbour_index, new_distance);
+                    direction.parents[neighbour_index] = ParentEdge{index, position};
+                    direction.queue.push(neighbour_index, new_distance);
                 }
+            });
+        }
+    }
+
+    template<typename Queue>
+    int CHGraph::compute_shortest_path_parallel(int source, int target, CHQueryWorkspace<Queue> &workspace,
+                                                WorkStealingPool &pool) const {
+        // invalid node index
+        if (source >= m_node_index_map.size() || target >= m_node_index_map.size()) {
+            return -1;
+        }
+
+        source = m_node_index_map[source];
+        target = m_node_index_map[target];
+
+        workspace.reset(static_cast<int>(m_node_index_map.size()));
+        CHSearchDirection<Queue> forward{
+            m_edges, PackedCHEdges::UP, PackedCHEdges::DOWN,
+            workspace.up_distances, workspace.down_distances, workspace.up_parents, workspace.up_queue
+        };
+        CHSearchDirection<Queue> backward{
+            m_edges, PackedCHEdges::DOWN, PackedCHEdges::UP,
+            workspace.down_distances, workspace.up_distances, workspace.down_parents, workspace.down_queue
+        };
+
+        int stalled_nodes[2] = {0, 0};
+        pool.parallel_for(2, [&](int, const int item) {
+            if (item == 0) {
+                run_parallel_query_direction(source, forward, workspace.up_settled_nodes, stalled_nodes[0]);
             } else {
-                for (int i = m_down_edges_offsets[index]; i < m_down_edges_offsets[index + 1]; ++i) {
-                    const auto [neighbour_index, weight] = m_down_edges[i];
-                    if (const auto new_distance = distance + weight; new_distance < down_distances[neighbour_index]) {
-                        down_distances[neighbour_index] = new_distance;
-                        queue.push(SPNode{neighbour_index, new_distance, false});
-                    }
-                }
+                run_parallel_query_direction(target, backward, workspace.down_settled_nodes, stalled_nodes[1]);
+            }
+        });
+        workspace.settled_nodes = static_cast<int>(workspace.up_settled_nodes.size()
+                                                   + workspace.down_settled_nodes.size());
+        workspace.stalled_nodes = stalled_nodes[0] + stalled_nodes[1];
+
+        // the highest node of a shortest path is settled by both searches, so the shorter list suffices
+        const auto scan_forward = workspace.up_settled_nodes.size() <= workspace.down_settled_nodes.size();
+        const auto &settled_nodes = scan_forward ? workspace.up_settled_nodes : workspace.down_settled_nodes;
+        int valid_min_distance = std::numeric_limits<int>::max();
+        for (const auto index: settled_nodes) {
+            const auto up_distance = workspace.up_distances.get(index);
+            const auto down_distance = workspace.down_distances.get(index);
+            if (up_distance != TimestampedDistances::INFINITE_DISTANCE
+                && down_distance != TimestampedDistances::INFINITE_DISTANCE
+                && up_distance + down_distance < valid_min_distance) {
+                valid_min_distance = up_distance + down_distance;
+                workspace.meeting_node = index;
             }
         }
 
@@ -115,46 +435,228 @@ namespace exercise::two {
         return valid_min_distance;
     }
 
-    int CHGraph::get_node_count() const {
-        return static_cast<int>(m_node_index_map.size());
-    }
+    template int CHGraph::compute_shortest_path_parallel(int, int, CHQueryWorkspace<BinaryHeap> &,
+                                                         WorkStealingPool &) const;
+    template int CHGraph::compute_shortest_path_parallel(int, int, CHQueryWorkspace<QuaternaryHeap> &,
+                                                         WorkStealingPool &) const;
+    template int CHGraph::compute_shortest_path_parallel(int, int, CHQueryWorkspace<RadixHeap> &,
+                                                         WorkStealingPool &) const;
+
+    /// Dijkstra over the edges to higher nodes, calls visit(index, distance) for every settled node that isn't
+    /// stalled. Without a target the search can only stop once the queue is empty
+    template<typename Visit>
+    static void run_upward_search(const int start, const PackedCHEdges &edges, const uint32_t direction,
+                                  const uint32_t stall_direction, TimestampedDistances &distances, BinaryHeap &queue,
+                                  const Visit &visit) {
+        distances.reset();
+        queue.reset(edges.get_node_count());
+        distances.set(start, 0);
+        queue.push(start, 0);
+
+        while (!queue.empty()) {
+            const auto [index, distance] = queue.pop();
+
+            // old invalid entry, not removed for performance
+            if (distance > distances.get(index)) {
+                continue;
+            }
 
-    static void calculate_offset_array_out_edges(const std::vector<CHEdge> &edges,
-                                                 std::vector<int> &offsets,
-                                                 const int node_count) {
-        offsets.resize(node_count + 1);
-        int last_from = -1;
-        for (int i = 0; i < edges.size(); ++i) {
-            if (const auto from = edges[i].from; last_from != from) {
-                for (int j = from; j > last_from; --j) {
-                    offsets[j] = i;
+            // a higher node reaches this node on a shorter path, the bucket entries of the higher node suffice
+            const auto is_reached_shorter = [&distances, distance](const Edge edge) {
+                const auto higher_distance = distances.get(edge.to);
+                return higher_distance != TimestampedDistances::INFINITE_DISTANCE
+                       && higher_distance + edge.weight < distance;
+            };
+            if (edges.any_edge(index, stall_direction, is_reached_shorter)) {
+                continue;
+            }
+
+            visit(index, distance);
+
+            edges.for_each_edge(index, direction, [&](int, const Edge edge) {
+                const auto [neighbour_index, weight] = edge;
+                if (const auto new_distance = distance + weight; new_distance < distances.get(neighbour_index)) {
+                    distances.set(neighbour_index, new_distance);
+                    queue.push(neighbour_index, new_distance);
                 }
-                last_from = from;
+            });
+        }
+    }
+
+    std::vector<int> CHGraph::compute_distance_table(const std::vector<int> &sources, const std::vector<int> &targets,
+                                                     const int thread_count) const {
+        struct BucketItem {
+            int index;
+            int target;
+            int distance;
+        };
+
+        const auto node_count = get_node_count();
+        const auto target_count = static_cast<int>(targets.size());
+        const auto is_valid = [node_count](const int node) { return node >= 0 && node < node_count; };
+
+        // backward searches, every target leaves its distance at all nodes it reaches upwards
+        std::vector<std::vector<BucketItem> > chunk_items(std::max(1, thread_count));
+        std::atomic<int> next_chunk = 0;
+        parallel_for_chunks(targets.size(), thread_count, [&](const size_t begin, const size_t end) {
+            auto &items = chunk_items[next_chunk++];
+            TimestampedDistances distances(node_count);
+            BinaryHeap queue;
+            for (auto j = begin; j < end; ++j) {
+                if (!is_valid(targets[j]))
+                    continue;
+
+                run_upward_search(m_node_index_map[targets[j]], m_edges, PackedCHEdges::DOWN,
+                                  PackedCHEdges::UP, distances, queue,
+                                  [&items, j](const int index, const int distance) {
+                                      items.push_back(BucketItem{index, static_cast<int>(j), distance});
+                                  });
+            }
+        });
+
+        std::vector<BucketItem> bucket_items;
+        for (auto &items: chunk_items) {
+            bucket_items.insert(bucket_items.end(), items.begin(), items.end());
+            items = std::vector<BucketItem>();
+        }
+        std::vector<int> bucket_offsets;
+        std::vector<BucketItem> buckets;
+        build_csr(bucket_items, node_count, bucket_offsets, buckets,
+                  [](const BucketItem &item) { return item.index; },
+                  [](const BucketItem &item) { return item; },
+                  thread_count);
+        bucket_items = std::vector<BucketItem>();
+
+        // forward searches, the rows of the sources are independent
+        std::vector<int> table(sources.size() * targets.size(), TimestampedDistances::INFINITE_DISTANCE);
+        parallel_for_chunks(sources.size(), thread_count, [&](const size_t begin, const size_t end) {
+            TimestampedDistances distances(node_count);
+            BinaryHeap queue;
+            for (auto i = begin; i < end; ++i) {
+                if (!is_valid(sources[i]))
+                    continue;
+
+                const auto row = table.begin() + static_cast<long long>(i) * target_count;
+                run_upward_search(m_node_index_map[sources[i]], m_edges, PackedCHEdges::UP,
+                                  PackedCHEdges::DOWN, distances, queue,
+                                  [&](const int index, const int distance) {
+                                      for (int k = bucket_offsets[index]; k < bucket_offsets[index + 1]; ++k) {
+                                          const auto &entry = buckets[k];
+                                          row[entry.target] = std::min(row[entry.target],
+                                                                       distance + entry.distance);
+                                      }
+                                  });
+            }
+        });
+
+        // no path exists, an invalid distance like the single queries
+        for (auto &distance: table) {
+            if (distance == TimestampedDistances::INFINITE_DISTANCE) {
+                distance = -1;
             }
         }
-        offsets[node_count] = static_cast<int>(edges.size());
+        return table;
     }
 
-    static void calculate_offset_array_in_edges(const std::vector<CHEdge> &edges,
-                                                std::vector<int> &offsets,
-                                                const int node_count) {
-        offsets.resize(node_count + 1);
-        int last_to = -1;
-        for (int i = 0; i < edges.size(); ++i) {
-            if (const auto to = edges[i].to; last_to != to) {
-                for (int j = to; j > last_to; --j) {
-                    offsets[j] = i;
-                }
-                last_to = to;
+    std::vector<int> CHGraph::compute_path(const int source, const int target) const {
+        thread_local CHQueryWorkspace<> workspace;
+        std::vector<int> path;
+        if (compute_shortest_path(source, target, workspace) != -1) {
+            unpack_path(workspace, path);
+        }
+        return path;
+    }
+
+    template<typename Queue>
+    void CHGraph::unpack_path(const CHQueryWorkspace<Queue> &workspace, std::vector<int> &path) const {
+        path.clear();
+        const auto meeting_node = workspace.meeting_node;
+        if (meeting_node == -1)
+            return;
+
+        // the up search is followed backwards from the meeting node to the source
+        std::vector<ParentEdge> up_edges;
+        for (auto node = meeting_node; workspace.up_distances.get(node) != 0;) {
+            const auto parent = workspace.up_parents[node];
+            up_edges.push_back(parent);
+            node = parent.node;
+        }
+
+        auto node = meeting_node;
+        if (!up_edges.empty()) {
+            node = up_edges.back().node;
+        }
+        path.push_back(m_node_ids[node]);
+        for (auto it = up_edges.rbegin(); it != up_edges.rend(); ++it) {
+            const auto edge = m_edges.get_edge(it->node, it->edge);
+            unpack_edge(it->node, edge.to, m_edges.get_middle_node(it->edge), path);
+        }
+
+        // the down search already points from the meeting node towards the target
+        for (node = meeting_node; workspace.down_distances.get(node) != 0;) {
+            const auto parent = workspace.down_parents[node];
+            unpack_edge(node, parent.node, m_edges.get_middle_node(parent.edge), path);
+            node = parent.node;
+        }
+    }
+
+    template void CHGraph::unpack_path(const CHQueryWorkspace<BinaryHeap> &, std::vector<int> &) const;
+    template void CHGraph::unpack_path(const CHQueryWorkspace<QuaternaryHeap> &, std::vector<int> &) const;
+    template void CHGraph::unpack_path(const CHQueryWorkspace<RadixHeap> &, std::vector<int> &) const;
+
+    void CHGraph::unpack_edge(const int from, const int to, const int middle, std::vector<int> &path) const {
+        if (middle == -1) {
+            path.push_back(m_node_ids[to]);
+            return;
+        }
+
+        // both halves of a shortcut are stored at the lower middle node, from -> middle as down edge and
+        // middle -> to as up edge, the shortcut was built from the lightest of any parallel edges
+        auto first_half = -1;
+        auto first_half_weight = 0;
+        auto second_half = -1;
+        auto second_half_weight = 0;
+        for (int i = m_edges.begin(middle); i < m_edges.end(middle); ++i) {
+            const auto [neighbour, weight] = m_edges.get_edge(middle, i);
+            const auto directions = m_edges.get_directions(i);
+            if ((directions & PackedCHEdges::DOWN) && neighbour == from
+                && (first_half == -1 || weight < first_half_weight)) {
+                first_half = i;
+                first_half_weight = weight;
+            }
+            if ((directions & PackedCHEdges::UP) && neighbour == to
+                && (second_half == -1 || weight < second_half_weight)) {
+                second_half = i;
+                second_half_weight = weight;
             }
         }
-        offsets[node_count] = static_cast<int>(edges.size());
+
+        unpack_edge(from, middle, m_edges.get_middle_node(first_half), path);
+        unpack_edge(middle, to, m_edges.get_middle_node(second_half), path);
+    }
+
+    int CHGraph::get_node_count() const {
+        return static_cast<int>(m_node_index_map.size());
+    }
+
+    int CHGraph::get_edge_count() const {
+        return m_edges.get_edge_count();
+    }
+
+    size_t CHGraph::get_query_graph_size() const {
+        return m_edges.get_memory_size();
     }
 
     void CHGraph::read_in_ch_graph(std::fstream input_file) {
         std::vector<CHNode> nodes;
         std::vector<CHEdge> edges;
-        const auto node_count = parse_ch_file(std::move(input_file), nodes, edges);
+        parse_ch_file(std::move(input_file), nodes, edges);
+        build_query_graph(std::move(nodes), edges);
+    }
+
+    void CHGraph::build_query_graph(std::vector<CHNode> nodes, const std::vector<CHEdge> &edges) {
+        const auto node_count = static_cast<int>(nodes.size());
+        const auto thread_count = static_cast<int>(std::thread::hardware_concurrency());
 
         // sorting nodes descending by level to improve cache locality
         std::sort(nodes.begin(), nodes.end(),
@@ -162,114 +664,81 @@ namespace exercise::two {
                       return a.level > b.level;
                   });
         m_node_index_map.resize(node_count);
+        m_node_ids.resize(node_count);
         for (int i = 0; i < nodes.size(); ++i) {
             m_node_index_map[nodes[i].id] = i;
+            m_node_ids[i] = nodes[i].id;
         }
 
-        // create up graph
-        {
-            // group edges by source
-            std::sort(edges.begin(), edges.end(),
-                      [](const auto &a, const auto &b) {
-                          return a.from < b.from;
-                      });
-            std::vector<int> original_edge_offsets;
-            calculate_offset_array_out_edges(edges, original_edge_offsets, node_count);
-
-            m_up_edges.reserve(edges.size());
-            m_up_edges_offsets.resize(node_count + 1);
-            int up_edge_head = 0;
-            for (int i = 0; i < nodes.size(); ++i) {
-                const auto [id, level] = nodes[i];
-                m_up_edges_offsets[i] = up_edge_head;
-
-                for (int j = original_edge_offsets[id]; j < original_edge_offsets[id + 1]; j++) {
-                    const auto edge = edges[j];
-                    const auto target = m_node_index_map[edge.to];
-                    if (nodes[target].level > level) {
-                        m_up_edges.push_back(Edge{target, edge.weight});
-                        up_edge_head++;
-                    }
-                }
-            }
-            m_up_edges_offsets[node_count] = up_edge_head;
-        }
+        const auto middle_index = [this](const CHEdge &edge) {
+            return edge.middle == -1 ? -1 : m_node_index_map[edge.middle];
+        };
 
-        // create down graph
-        {
-            // group edges by target
-            std::sort(edges.begin(), edges.end(),
-                      [](const auto &a, const auto &b) {
-                          return a.to < b.to;
-                      });
-            std::vector<int> original_in_edge_offsets;
-            calculate_offset_array_in_edges(edges, original_in_edge_offsets, node_count);
-
-            m_down_edges.reserve(edges.size());
-            m_down_edges_offsets.resize(node_count + 1);
-            int down_edge_head = 0;
-            for (int i = 0; i < nodes.size(); ++i) {
-                const auto [id, level] = nodes[i];
-                m_down_edges_offsets[i] = down_edge_head;
-
-                for (int j = original_in_edge_offsets[id]; j < original_in_edge_offsets[id + 1]; j++) {
-                    const auto edge = edges[j];
-                    const auto source = m_node_index_map[edge.from];
-                    if (nodes[source].level > level) {
-                        m_down_edges.push_back(Edge{source, edge.weight});
-                        down_edge_head++;
-                    }
-                }
+        // every edge is stored at its lower end, edges between nodes of the same level at both ends, because
+        // nodes left uncontracted at the end of the preprocessing share the top level
+        std::vector<PackedCHEdges::BuildEdge> build_edges;
+        build_edges.reserve(edges.size() * 2);
+        for (const auto &edge: edges) {
+            const auto from = m_node_index_map[edge.from];
+            const auto to = m_node_index_map[edge.to];
+            if (nodes[to].level >= nodes[from].level) {
+                build_edges.push_back(PackedCHEdges::BuildEdge{from, to, edge.weight, middle_index(edge),
+                                                               PackedCHEdges::UP});
+            }
+            if (nodes[from].level >= nodes[to].level) {
+                build_edges.push_back(PackedCHEdges::BuildEdge{to, from, edge.weight, middle_index(edge),
+                                                               PackedCHEdges::DOWN});
             }
-            m_down_edges_offsets[node_count] = down_edge_head;
         }
+        m_edges.build(node_count, build_edges, thread_count);
     }
 
-    static void contract_node(const std::vector<CHBuildNode> &nodes,
-                              ProgressiveDijkstra &dijkstra,
+    static void contract_node(const ContractionGraph &graph,
+                              WitnessSearch<> &witness_search,
                               const int node_index,
-                              std::list<FMIEdge> &shortcuts) {
-        const auto &node = nodes[node_index];
+                              std::vector<CHEdge> &shortcuts) {
+        int max_out_weight = 0;
+        for (auto [_, out_weight]: graph.get_out_edges(node_index)) {
+            max_out_weight = std::max(max_out_weight, out_weight);
+        }
 
-        for (auto [in_node, in_weight]: node.in_edges) {
-            dijkstra.set_source(in_node);
+        for (auto [in_node, in_weight]: graph.get_in_edges(node_index)) {
+            // one search per in node covers all out nodes, witnesses longer than the longest path over
+            // this node are useless
+            witness_search.run(in_node, node_index, in_weight + max_out_weight);
 
-            for (auto [out_node, out_weight]: node.out_edges) {
+            for (auto [out_node, out_weight]: graph.get_out_edges(node_index)) {
                 if (in_node == out_node)
                     continue;
 
-                // check if shortest-path from in_node to out_node goes over this node
-                const int distance = dijkstra.shortest_path_to(out_node);
+                // check if the shortest path from in_node to out_node has to go over this node, a witness of the
+                // same length could go over another node of the independent set that skips its shortcut for the
+                // same reason
                 const int direct_distance = in_weight + out_weight;
-                if (distance < direct_distance)
+                if (witness_search.get_distance(out_node) < direct_distance)
                     continue;
 
                 // if yes then add shortcut
-                shortcuts.push_back(FMIEdge{in_node, out_node, distance});
+                shortcuts.push_back(CHEdge{in_node, out_node, direct_distance, node_index});
             }
         }
     }
 
-    static std::vector<int> find_independent_set(const std::vector<CHBuildNode> &nodes,
+    static std::vector<int> find_independent_set(const ContractionGraph &graph,
                                                  std::vector<int> &uncontracted_nodes) {
         std::unordered_set<int> independent_set;
 
         // sort nodes by upper bound for edge difference = shortcuts_added - edges_deleted
         std::sort(uncontracted_nodes.begin(), uncontracted_nodes.end(),
-                  [&nodes](auto a, auto b) {
-                      const CHBuildNode &nodeA = nodes[a];
-                      const CHBuildNode &nodeB = nodes[b];
-                      const int edgeDiffA = (static_cast<int>(nodeA.in_edges.size()) - 1) * (
-                                                static_cast<int>(nodeA.out_edges.size()) - 1);
-                      const int edgeDiffB = (static_cast<int>(nodeB.in_edges.size()) - 1) * (
-                                                static_cast<int>(nodeB.out_edges.size()) - 1);
+                  [&graph](auto a, auto b) {
+                      const int edgeDiffA = (graph.get_in_edges(a).size() - 1) * (graph.get_out_edges(a).size() - 1);
+                      const int edgeDiffB = (graph.get_in_edges(b).size() - 1) * (graph.get_out_edges(b).size() - 1);
                       return edgeDiffA < edgeDiffB;
                   });
 
         for (const auto node_index: uncontracted_nodes) {
-            const auto &node = nodes[node_index];
             bool independent = true;
-            for (auto [in_node, _]: node.in_edges) {
+            for (auto [in_node, _]: graph.get_in_edges(node_index)) {
                 if (independent_set.find(in_node) != independent_set.end()) {
                     independent = false;
                     break;
@@ -279,7 +748,7 @@ namespace exercise::two {
                 continue;
             }
 
-            for (auto [out_node, _]: node.out_edges) {
+            for (auto [out_node, _]: graph.get_out_edges(node_index)) {
                 if (independent_set.find(out_node) != independent_set.end()) {
                     independent = false;
                     break;
@@ -289,14 +758,37 @@ namespace exercise::two {
                 continue;
             }
 
-            independent_set.emplace(node.id);
+            independent_set.emplace(node_index);
         }
 
         return std::vector<int>{std::begin(independent_set), std::end(independent_set)};
     }
 
-    static int preprocess_graph(std::vector<CHBuildNode> &nodes, const int node_count, const int edge_count) {
-        constexpr int PARALLEL_DIJKSTRAS = 16;
+    static void print_witness_search_statistics(const std::string &name, const WitnessSearchStatistics &statistics) {
+        const auto average_settled_nodes = statistics.searches == 0
+                                               ? 0.0
+                                               : static_cast<double>(statistics.settled_nodes) / statistics.searches;
+        std::cout << "[Info] Witness searches for " << name << ": " << statistics.searches << " searches, " <<
+                statistics.settled_nodes << " settled nodes [" << std::round(average_settled_nodes * 10) / 10 <<
+                " per search], " << statistics.settle_limit_hits << " stopped by the settle limit" << std::endl;
+    }
+
+    /// Contracts the working graph level by level, assigns the levels to the nodes and appends the shortcuts to edges
+    static void preprocess_graph(ContractionGraph &working_graph, std::vector<CHNode> &nodes,
+                                 std::vector<CHEdge> &edges, const WitnessSearchLimits &limits,
+                                 const int thread_count) {
+        const auto node_count = static_cast<int>(nodes.size());
+        const auto edge_count = static_cast<int>(edges.size());
+
+        // the threads, their witness search memory and shortcut buffers are kept over all levels
+        WorkStealingPool pool(thread_count);
+        std::vector<WitnessSearch<> > witness_searches;
+        std::vector<std::vector<CHEdge> > shortcut_buffers(pool.get_thread_count());
+        witness_searches.reserve(pool.get_thread_count());
+        for (int i = 0; i < pool.get_thread_count(); ++i) {
+            witness_searches.emplace_back(working_graph, limits);
+            shortcut_buffers[i].reserve(edge_count / pool.get_thread_count());
+        }
 
         std::vector<bool> contracted;
         contracted.resize(nodes.size(), false);
@@ -305,47 +797,28 @@ namespace exercise::two {
         for (const auto &node: nodes) {
             uncontracted_nodes.push_back(node.id);
         }
-        auto independent_set_handle = std::async(std::launch::async, find_independent_set, std::ref(nodes),
-                                                 std::ref(uncontracted_nodes));
-
-        // generate CH working graph
-        std::vector<CHBuildNode> working_nodes;
-        working_nodes.resize(nodes.size());
-        for (auto &[id, level, in_edges, out_edges]: nodes) {
-            auto copy = CHBuildNode{id, level};
-            copy.in_edges.insert(copy.in_edges.begin(), in_edges.begin(), in_edges.end());
-            copy.out_edges.insert(copy.out_edges.begin(), out_edges.begin(), out_edges.end());
-
-            working_nodes[id] = copy;
-        }
 
         int level = 0;
         int shortcuts_added = 0;
         int nodes_contracted = 0;
+        WitnessSearchStatistics statistics;
 
         while (shortcuts_added < edge_count) {
             std::cout << "[Info] Finding independent set for level " << level << std::endl;
-            auto independent_set = independent_set_handle.get();
+            auto independent_set = find_independent_set(working_graph, uncontracted_nodes);
             if (independent_set.empty())
                 break;
 
             std::cout << "[Info] Contracting nodes of independent set with " << independent_set.size() <<
-                    " nodes for level " << level << " in parallel" << std::endl;
-            std::array<std::future<std::list<FMIEdge> >, PARALLEL_DIJKSTRAS> threads;
-            const int nodes_per_thread = std::ceil(
-                static_cast<double>(independent_set.size()) / static_cast<double>(threads.size()));
-            for (int i = 0; i < threads.size(); ++i) {
-                threads[i] = std::async(std::launch::async, [independent_set, working_nodes, nodes_per_thread, i]() {
-                    ProgressiveDijkstra dijkstra{working_nodes};
-                    std::list<FMIEdge> shortcuts;
-                    const auto last_node = std::min(nodes_per_thread * (i + 1),
-                                                    static_cast<int>(independent_set.size()));
-                    for (int j = i * nodes_per_thread; j < last_node; ++j) {
-                        contract_node(working_nodes, dijkstra, independent_set[i], shortcuts);
-                    }
-                    return shortcuts;
-                });
+                    " nodes for level " << level << " with " << pool.get_thread_count() << " threads" << std::endl;
+            // the working graph is only read during the round, the shortcuts are added after all threads are done
+            for (auto &buffer: shortcut_buffers) {
+                buffer.clear();
             }
+            pool.parallel_for(static_cast<int>(independent_set.size()), [&](const int thread_index, const int i) {
+                contract_node(working_graph, witness_searches[thread_index], independent_set[i],
+                              shortcut_buffers[thread_index]);
+            });
 
             // update remaining uncontracted nodes set
             std::vector<int> remaining_uncontracted_nodes{};
@@ -359,26 +832,28 @@ namespace exercise::two {
                 remaining_uncontracted_nodes.push_back(node_index);
             }
 
-            // join threads
-            std::list<FMIEdge> shortcuts;
-            for (auto &thread: threads) {
-                auto result = thread.get();
-                shortcuts.insert(shortcuts.begin(), result.begin(), result.end());
+            WitnessSearchStatistics level_statistics;
+            for (auto &witness_search: witness_searches) {
+                level_statistics += witness_search.statistics();
+                witness_search.reset_statistics();
             }
+            statistics += level_statistics;
+            print_witness_search_statistics("level " + std::to_string(level), level_statistics);
 
-            // add shortcuts
-            std::cout << "[Info] Adding " << shortcuts.size() << " shortcuts for level " << level << std::endl;
-            for (auto &[from, to, weight]: shortcuts) {
-                // add shortcuts to graph
-                nodes[from].out_edges.emplace_back(to, weight);
-                nodes[to].in_edges.emplace_back(from, weight);
-
-                // and also to work graph
-                working_nodes[from].out_edges.emplace_back(to, weight);
-                working_nodes[to].in_edges.emplace_back(from, weight);
+            // add shortcuts to the hierarchy and the working graph
+            int level_shortcut_count = 0;
+            for (const auto &buffer: shortcut_buffers) {
+                level_shortcut_count += static_cast<int>(buffer.size());
+            }
+            std::cout << "[Info] Adding " << level_shortcut_count << " shortcuts for level " << level << std::endl;
+            for (const auto &buffer: shortcut_buffers) {
+                edges.insert(edges.end(), buffer.begin(), buffer.end());
+                for (const auto &shortcut: buffer) {
+                    working_graph.add_edge(shortcut.from, shortcut.to, shortcut.weight);
+                }
             }
 
-            shortcuts_added += static_cast<int>(shortcuts.size());
+            shortcuts_added += level_shortcut_count;
             nodes_contracted += static_cast<int>(independent_set.size());
 
             if (remaining_uncontracted_nodes.empty()) {
@@ -396,27 +871,17 @@ namespace exercise::two {
                 }
                 level++;
                 // assign all uncontracted nodes to the top level
-                for (const int node: uncontracted_nodes) {
+                for (const int node: remaining_uncontracted_nodes) {
                     nodes[node].level = level;
                 }
                 break;
             }
 
-            // prepare next independent set
-            uncontracted_nodes = remaining_uncontracted_nodes;
-            independent_set_handle = std::async(std::launch::async, find_independent_set, nodes,
-                                                std::ref(uncontracted_nodes));
+            uncontracted_nodes = std::move(remaining_uncontracted_nodes);
 
-            // delete node from working graph
+            // delete contracted nodes from working graph
             for (const auto node: independent_set) {
-                // delete node in working graph by deleting all in_edges and out_edges
-                for (auto [in_node, in_edge]: working_nodes[node].in_edges) {
-                    working_nodes[in_node].remove_out_edge(node);
-                }
-                for (auto [out_node, out_edge]: working_nodes[node].out_edges) {
-                    working_nodes[out_node].remove_in_edge(node);
-                }
-                // assign level
+                working_graph.remove_node(node);
                 nodes[node].level = level;
             }
             level++;
@@ -430,59 +895,126 @@ namespace exercise::two {
         std::cout << "[Progress: 100%] " << shortcuts_added << " shortcuts added" << std::endl;
         std::cout << "[Info] Contracted " << nodes_contracted << " out of " << node_count << " nodes [" <<
                 nodes_contracted_percent << "%]" << std::endl;
-
-        return edge_count + shortcuts_added;
+        print_witness_search_statistics("all levels", statistics);
     }
 
-    void CHGraph::generate_ch_graph(std::fstream input_file) {
-        // Read-in fmi file
-        std::vector<CHBuildNode> nodes;
-        auto edge_count = parse_fmi_file(std::move(input_file), nodes);
-        const auto node_count = static_cast<int>(nodes.size());
+    /// Contracts the nodes one at a time in order of their priority and appends the shortcuts to edges. A contraction
+    /// only changes the priorities of the neighbours, so only they are updated right away, outdated priorities of
+    /// other nodes are noticed when they reach the top of the queue
+    static void preprocess_graph_by_priority(ContractionGraph &working_graph, std::vector<CHNode> &nodes,
+                                             std::vector<CHEdge> &edges, const WitnessSearchLimits &limits,
+                                             const WitnessSearchLimits &simulation_limits) {
+        constexpr int EDGE_DIFFERENCE_WEIGHT = 1;
+        constexpr int DELETED_NEIGHBOURS_WEIGHT = 1;
+        constexpr int DEPTH_WEIGHT = 1;
 
-        // Preprocess graph to ch graph
-        std::cout << "[Info] Preprocessing graph for CH" << std::endl;
-        edge_count = preprocess_graph(nodes, node_count, edge_count);
+        const auto node_count = static_cast<int>(nodes.size());
+        WitnessSearch<> witness_search{working_graph, limits};
+        WitnessSearch<> simulation_witness_search{working_graph, simulation_limits};
+        std::vector<CHEdge> shortcuts;
+        std::vector<int> deleted_neighbours(node_count, 0);
+        // upper bound for the hops of a search in the hierarchy that ends at the node
+        std::vector<int> depths(node_count, 0);
+
+        const auto compute_priority = [&](const int node) {
+            shortcuts.clear();
+            contract_node(working_graph, simulation_witness_search, node, shortcuts);
+            const int edge_difference = static_cast<int>(shortcuts.size()) - working_graph.get_in_edges(node).size()
+                                        - working_graph.get_out_edges(node).size();
+            return EDGE_DIFFERENCE_WEIGHT * edge_difference + DELETED_NEIGHBOURS_WEIGHT * deleted_neighbours[node]
+                   + DEPTH_WEIGHT * depths[node];
+        };
 
-        // Create data structure for query
-        std::cout << "[Info] Generating query data structure" << std::endl;
-        // sorting nodes descending by level to improve cache locality
-        std::sort(nodes.begin(), nodes.end(),
-                  [](const auto &a, const auto &b) {
-                      return a.level > b.level;
-                  });
-        m_node_index_map.resize(node_count);
-        for (int i = 0; i < nodes.size(); ++i) {
-            m_node_index_map[nodes[i].id] = i;
+        std::cout << "[Info] Computing initial priorities of " << node_count << " nodes" << std::endl;
+        QuaternaryHeap queue;
+        queue.reset(node_count);
+        for (int node = 0; node < node_count; ++node) {
+            queue.push(node, compute_priority(node));
         }
 
-        m_up_edges.resize(edge_count);
-        m_down_edges.resize(edge_count);
+        const int progress_step = std::max(1, node_count / 20);
+        int level = 0;
+        int shortcuts_added = 0;
+        std::vector<int> neighbours;
+        while (!queue.empty()) {
+            const auto node = queue.pop().index;
+
+            // lazy update, the priority may have grown since the node was pushed
+            const auto priority = compute_priority(node);
+            if (!queue.empty() && priority > queue.top().distance) {
+                queue.push(node, priority);
+                continue;
+            }
 
-        m_up_edges_offsets.resize(node_count + 1);
-        m_down_edges_offsets.resize(node_count + 1);
+            nodes[node].level = level++;
+            shortcuts.clear();
+            contract_node(working_graph, witness_search, node, shortcuts);
+            for (const auto &shortcut: shortcuts) {
+                edges.push_back(shortcut);
+                working_graph.add_edge(shortcut.from, shortcut.to, shortcut.weight);
+            }
+            shortcuts_added += static_cast<int>(shortcuts.size());
 
-        int up_edge_head = 0;
-        int down_edge_head = 0;
-        for (const auto &[id, level, in_edges, out_edges]: nodes) {
-            const auto new_index = m_node_index_map[id];
-            m_up_edges_offsets[new_index] = up_edge_head;
-            m_down_edges_offsets[new_index] = down_edge_head;
+            neighbours.clear();
+            for (const auto [in_node, _]: working_graph.get_in_edges(node)) {
+                neighbours.push_back(in_node);
+            }
+            for (const auto [out_node, _]: working_graph.get_out_edges(node)) {
+                neighbours.push_back(out_node);
+            }
+            std::sort(neighbours.begin(), neighbours.end());
+            neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+
+            working_graph.remove_node(node);
+            for (const auto neighbour: neighbours) {
+                deleted_neighbours[neighbour]++;
+                depths[neighbour] = std::max(depths[neighbour], depths[node] + 1);
+                queue.update(neighbour, compute_priority(neighbour));
+            }
 
-            for (const auto &[out_node, out_weight]: out_edges) {
-                const auto new_out_id = m_node_index_map[out_node];
-                if (nodes[new_out_id].level >= level) {
-                    m_up_edges[up_edge_head++] = Edge{new_out_id, out_weight};
-                }
+            if (level % progress_step == 0) {
+                const auto progress_percent = std::round((1000.0 * level) / node_count) / 10.0;
+                std::cout << "[Progress: " << progress_percent << "%] " << level << " nodes contracted, " <<
+                        shortcuts_added << " shortcuts added" << std::endl;
             }
-            for (const auto &[in_node, in_weight]: in_edges) {
-                const auto new_in_id = m_node_index_map[in_node];
-                if (nodes[new_in_id].level >= level) {
-                    m_down_edges[down_edge_head++] = Edge{new_in_id, in_weight};
-                }
+        }
+
+        std::cout << "[Progress: 100%] " << shortcuts_added << " shortcuts added" << std::endl;
+        print_witness_search_statistics("the simulated contractions", simulation_witness_search.statistics());
+        print_witness_search_statistics("all nodes", witness_search.statistics());
+    }
+
+    void CHGraph::generate_ch_graph(std::fstream input_file, const CHPreprocessingOptions &options) {
+        // Read-in fmi file
+        std::vector<FMIEdge> fmi_edges;
+        const auto node_count = parse_fmi_file(std::move(input_file), fmi_edges);
+
+        std::vector<CHNode> nodes(node_count);
+        for (int i = 0; i < node_count; ++i) {
+            nodes[i] = CHNode{i, 0};
+        }
+        // the hierarchy keeps all original edges, the shortcuts are appended during the contraction
+        std::vector<CHEdge> edges;
+        edges.reserve(2 * fmi_edges.size());
+        for (const auto &[from, to, weight]: fmi_edges) {
+            edges.push_back(CHEdge{from, to, weight});
+        }
+
+        // Preprocess graph to ch graph
+        std::cout << "[Info] Preprocessing graph for CH" << std::endl;
+        {
+            ContractionGraph working_graph(node_count, fmi_edges);
+            fmi_edges = std::vector<FMIEdge>();
+            if (options.ordering == NodeOrdering::Priority) {
+                preprocess_graph_by_priority(working_graph, nodes, edges, options.witness_search_limits,
+                                             options.simulation_witness_search_limits);
+            } else {
+                preprocess_graph(working_graph, nodes, edges, options.witness_search_limits, options.thread_count);
             }
         }
-        m_up_edges_offsets[node_count] = edge_count;
-        m_down_edges_offsets[node_count] = edge_count;
+
+        // Create data structure for query
+        std::cout << "[Info] Generating query data structure" << std::endl;
+        build_query_graph(std::move(nodes), edges);
     }
 }
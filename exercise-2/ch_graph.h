@@ -7,33 +7,123 @@
 
 
 #include <fstream>
+#include <optional>
+#include <string>
+#include <thread>
 #include <vector>
 
+#include "packed_ch_edges.h"
+#include "parse_ch_graph_file.h"
+#include "query_workspace.h"
+#include "thread_pool.h"
+#include "witness_search.h"
+
 namespace exercise::two {
-    struct Edge {
-        int to;
-        int weight;
+    enum class NodeOrdering {
+        /// contracts an independent set of nodes in parallel per level
+        IndependentSet,
+        /// contracts one node at a time by edge difference, deleted neighbours and search space depth
+        Priority
+    };
+
+    /// Only used when the hierarchy is generated from a fmi file
+    struct CHPreprocessingOptions {
+        NodeOrdering ordering = NodeOrdering::IndependentSet;
+        WitnessSearchLimits witness_search_limits;
+        /// the priority ordering simulates far more contractions than it performs, rough estimates are enough there
+        WitnessSearchLimits simulation_witness_search_limits{50, 3};
+        /// threads contracting an independent set, the priority ordering is sequential
+        int thread_count = static_cast<int>(std::thread::hardware_concurrency());
     };
 
     class CHGraph {
     public:
-        explicit CHGraph(std::fstream input_file, bool is_ch_graph);
+        explicit CHGraph(std::fstream input_file, bool is_ch_graph, const CHPreprocessingOptions &options = {});
+
+        /// Writes the query data structure into a binary snapshot, that can be loaded again without any preprocessing
+        [[nodiscard]] bool save(const std::string &file_name) const;
+
+        /// Loads a graph written by save(), returns nothing if the file is missing, outdated or corrupted
+        static std::optional<CHGraph> from_snapshot(const std::string &file_name);
+
+        /// Writes the hierarchy in the text .ch format, shortcuts reference their two child edges. The nodes keep
+        /// their relative levels, coordinates aren't stored in the graph and are written as 0. The lines are
+        /// formatted in parallel and written in large blocks
+        [[nodiscard]] bool save_ch(const std::string &file_name,
+                                   int thread_count = static_cast<int>(std::thread::hardware_concurrency())) const;
+
+        /// Reads a .ch file with the parallel parser, returns nothing if the file is missing or truncated
+        static std::optional<CHGraph> from_ch_file(const std::string &file_name,
+                                                   int thread_count = static_cast<int>(
+                                                       std::thread::hardware_concurrency()));
 
         [[nodiscard]] int compute_shortest_path(int source, int target) const;
+        /// Same query, but all memory is taken from the given workspace, so it runs in O(touched nodes).
+        /// Stall-on-demand skips the edges of nodes that are reached shorter over a higher node.
+        /// Instantiated for the BinaryHeap, QuaternaryHeap and RadixHeap queues
+        template<typename Queue>
+        [[nodiscard]] int compute_shortest_path(int source, int target, CHQueryWorkspace<Queue> &workspace,
+                                                bool stall_on_demand = true) const;
+
+        /// Same query, but the forward search runs on the calling thread and the backward search on another thread
+        /// of the pool, each on its own distances and queue of the workspace. As the searches can't see each other,
+        /// both run until their queue is empty and the shortest path is joined over the settled nodes afterwards.
+        /// The path can be unpacked like the one of the sequential query. Instantiated for the BinaryHeap,
+        /// QuaternaryHeap and RadixHeap queues
+        template<typename Queue>
+        [[nodiscard]] int compute_shortest_path_parallel(int source, int target, CHQueryWorkspace<Queue> &workspace,
+                                                         WorkStealingPool &pool) const;
+
+        /// Nodes of a shortest path from source to target including both, empty if there is no path
+        [[nodiscard]] std::vector<int> compute_path(int source, int target) const;
+        /// Expands the shortest path found by the last query on the workspace into its nodes, the shortcuts are
+        /// replaced by the original edges. Instantiated for the BinaryHeap, QuaternaryHeap and RadixHeap queues
+        template<typename Queue>
+        void unpack_path(const CHQueryWorkspace<Queue> &workspace, std::vector<int> &path) const;
+
+        /// Distances from every source to every target in row-major order, the distance from sources[i] to
+        /// targets[j] is at i * targets.size() + j and -1 if there is no path. One upward search per target fills
+        /// buckets at the nodes it reaches, the upward searches of the sources then only scan these buckets
+        [[nodiscard]] std::vector<int> compute_distance_table(
+            const std::vector<int> &sources, const std::vector<int> &targets,
+            int thread_count = static_cast<int>(std::thread::hardware_concurrency())) const;
 
         [[nodiscard]] int get_node_count() const;
 
+        /// Edges of the up and down graphs together
+        [[nodiscard]] int get_edge_count() const;
+
+        /// Bytes of the edge arrays of the up and down graphs
+        [[nodiscard]] size_t get_query_graph_size() const;
+
+        /// The nodes are indexed in descending order of their level
+        [[nodiscard]] int get_node_index(const int node_id) const {
+            return m_node_index_map[node_id];
+        }
+
+        [[nodiscard]] int get_node_id(const int node_index) const {
+            return m_node_ids[node_index];
+        }
+
+        /// Up and down edges of all nodes by node index
+        [[nodiscard]] const PackedCHEdges &get_edges() const {
+            return m_edges;
+        }
+
     private:
         std::vector<int> m_node_index_map;
+        std::vector<int> m_node_ids;
 
-        std::vector<Edge> m_up_edges;
-        std::vector<int> m_up_edges_offsets;
+        PackedCHEdges m_edges;
 
-        std::vector<Edge> m_down_edges;
-        std::vector<int> m_down_edges_offsets;
+        CHGraph() = default;
 
         void read_in_ch_graph(std::fstream input_file);
-        void generate_ch_graph(std::fstream input_file);
+        /// Builds the up and down graphs from the levels of the nodes and all edges including the shortcuts
+        void build_query_graph(std::vector<CHNode> nodes, const std::vector<CHEdge> &edges);
+        void generate_ch_graph(std::fstream input_file, const CHPreprocessingOptions &options);
+        /// Appends the nodes after from on the edge to the path, shortcuts are expanded recursively
+        void unpack_edge(int from, int to, int middle, std::vector<int> &path) const;
     };
 } // exercise::one
 
@@ -0,0 +1,99 @@
+//
+// Created by Jost on 17/10/2026.
+//
+
+#include "contraction_graph.h"
+
+#include <algorithm>
+
+namespace exercise::two {
+    // contracting a node adds shortcuts to its neighbours, half the degree as slack absorbs most of them
+    static int initial_capacity(const int degree) {
+        return degree + degree / 2 + 2;
+    }
+
+    ContractionGraph::ContractionGraph(const int node_count, const std::vector<FMIEdge> &edges) {
+        m_out.build(node_count, edges, false);
+        m_in.build(node_count, edges, true);
+    }
+
+    int ContractionGraph::get_node_count() const {
+        return static_cast<int>(m_out.blocks.size());
+    }
+
+    void ContractionGraph::add_edge(const int from, const int to, const int weight) {
+        if (m_out.insert_or_decrease(from, CHBuildEdge{to, weight})) {
+            m_in.insert_or_decrease(to, CHBuildEdge{from, weight});
+        }
+    }
+
+    void ContractionGraph::remove_node(const int node) {
+        for (const auto &[in_node, _]: get_in_edges(node)) {
+            m_out.erase(in_node, node);
+        }
+        for (const auto &[out_node, _]: get_out_edges(node)) {
+            m_in.erase(out_node, node);
+        }
+        m_out.blocks[node].size = 0;
+        m_in.blocks[node].size = 0;
+    }
+
+    void ContractionGraph::Adjacency::build(const int node_count, const std::vector<FMIEdge> &fmi_edges,
+                                            const bool by_target) {
+        blocks.assign(node_count, Block{0, 0, 0});
+        for (const auto &edge: fmi_edges) {
+            blocks[by_target ? edge.to : edge.from].capacity++;
+        }
+
+        int begin = 0;
+        for (auto &block: blocks) {
+            block.begin = begin;
+            block.capacity = initial_capacity(block.capacity);
+            begin += block.capacity;
+        }
+        edges.resize(begin);
+
+        for (const auto &[from, to, weight]: fmi_edges) {
+            auto &block = blocks[by_target ? to : from];
+            edges[block.begin + block.size++] = CHBuildEdge{by_target ? from : to, weight};
+        }
+    }
+
+    bool ContractionGraph::Adjacency::insert_or_decrease(const int node, const CHBuildEdge edge) {
+        auto &block = blocks[node];
+        const auto first = edges.begin() + block.begin;
+        const auto last = first + block.size;
+        if (const auto existing = std::find_if(first, last, [&edge](const CHBuildEdge &other) {
+            return other.neighbour == edge.neighbour;
+        }); existing != last) {
+            if (existing->weight <= edge.weight)
+                return false;
+
+            existing->weight = edge.weight;
+            return true;
+        }
+
+        // the block is full, move it to the end of the array with twice the capacity
+        if (block.size == block.capacity) {
+            const auto new_begin = static_cast<int>(edges.size());
+            block.capacity = std::max(2, block.capacity * 2);
+            edges.resize(edges.size() + block.capacity);
+            std::copy_n(edges.begin() + block.begin, block.size, edges.begin() + new_begin);
+            block.begin = new_begin;
+        }
+
+        edges[block.begin + block.size++] = edge;
+        return true;
+    }
+
+    void ContractionGraph::Adjacency::erase(const int node, const int neighbour) {
+        auto &block = blocks[node];
+        for (int i = block.begin; i < block.begin + block.size; ++i) {
+            if (edges[i].neighbour == neighbour) {
+                edges[i] = edges[block.begin + block.size - 1];
+                block.size--;
+                return;
+            }
+        }
+    }
+} // exercise::two
@@ -0,0 +1,94 @@
+//
+// Created by Jost on 17/10/2026.
+//
+
+#ifndef CONTRACTION_GRAPH_H
+#define CONTRACTION_GRAPH_H
+
+#include <vector>
+
+#include "parse_fmi_graph_file.h"
+
+namespace exercise::two {
+    struct CHBuildEdge {
+        int neighbour{};
+        int weight{};
+
+        CHBuildEdge() = default;
+
+        CHBuildEdge(const int neighbour, const int weight) : neighbour(neighbour), weight(weight) {
+        }
+    };
+
+    /// The edges of one node, a view into the edge array that is invalidated by adding or removing edges
+    struct CHBuildEdgeRange {
+        const CHBuildEdge *first;
+        const CHBuildEdge *last;
+
+        [[nodiscard]] const CHBuildEdge *begin() const {
+            return first;
+        }
+
+        [[nodiscard]] const CHBuildEdge *end() const {
+            return last;
+        }
+
+        [[nodiscard]] int size() const {
+            return static_cast<int>(last - first);
+        }
+    };
+
+    /// Remaining graph during the contraction. The in and out edges of every node are stored in one contiguous
+    /// block with some slack, so shortcuts are appended in place and edges are removed by swapping in the last one.
+    /// A block that runs full moves to the end of the edge array with twice the capacity.
+    class ContractionGraph {
+    public:
+        ContractionGraph(int node_count, const std::vector<FMIEdge> &edges);
+
+        [[nodiscard]] int get_node_count() const;
+
+        [[nodiscard]] CHBuildEdgeRange get_out_edges(const int node) const {
+            return m_out.get_edges(node);
+        }
+
+        [[nodiscard]] CHBuildEdgeRange get_in_edges(const int node) const {
+            return m_in.get_edges(node);
+        }
+
+        /// Adds the edge, a parallel edge that already exists only keeps the smaller weight
+        void add_edge(int from, int to, int weight);
+
+        /// Removes all edges of the node from the graph, as done when it is contracted
+        void remove_node(int node);
+
+    private:
+        struct Block {
+            int begin;
+            int size;
+            int capacity;
+        };
+
+        /// Edge blocks of one direction
+        struct Adjacency {
+            std::vector<CHBuildEdge> edges;
+            std::vector<Block> blocks;
+
+            [[nodiscard]] CHBuildEdgeRange get_edges(const int node) const {
+                const auto &block = blocks[node];
+                return CHBuildEdgeRange{edges.data() + block.begin, edges.data() + block.begin + block.size};
+            }
+
+            void build(int node_count, const std::vector<FMIEdge> &edges, bool by_target);
+
+            /// Returns false if a parallel edge with a smaller or equal weight already exists
+            bool insert_or_decrease(int node, CHBuildEdge edge);
+
+            void erase(int node, int neighbour);
+        };
+
+        Adjacency m_out;
+        Adjacency m_in;
+    };
+} // exercise::two
+
+#endif //CONTRACTION_GRAPH_H
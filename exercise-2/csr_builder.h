@@ -0,0 +1,105 @@
+//
+// Created by Jost on 17/10/2026.
+//
+
+#ifndef CSR_BUILDER_H
+#define CSR_BUILDER_H
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace exercise::two {
+    /// Calls function(begin, end) for thread_count equally sized chunks of [0, count) on separate threads
+    template<typename Function>
+    void parallel_for_chunks(const size_t count, int thread_count, const Function &function) {
+        thread_count = static_cast<int>(std::clamp<size_t>(count, 1, std::max(1, thread_count)));
+        if (thread_count == 1) {
+            function(size_t{0}, count);
+            return;
+        }
+
+        std::vector<std::thread> threads;
+        threads.reserve(thread_count);
+        for (int i = 0; i < thread_count; ++i) {
+            threads.emplace_back([&function, count, thread_count, i]() {
+                function(count * i / thread_count, count * (i + 1) / thread_count);
+            });
+        }
+        for (auto &thread: threads) {
+            thread.join();
+        }
+    }
+
+    /// Groups items by their dense key in [0, key_count) with a counting sort and stores them in CSR layout:
+    /// the entries of key k are entries[offsets[k]] to entries[offsets[k + 1] - 1].
+    /// Runs in O(items + key_count), with one thread the order of items with the same key is kept.
+    template<typename Item, typename Entry, typename KeySelector, typename EntrySelector>
+    void build_csr(const std::vector<Item> &items, const int key_count,
+                   std::vector<int> &offsets, std::vector<Entry> &entries,
+                   const KeySelector &key, const EntrySelector &to_entry, const int thread_count) {
+        offsets.assign(key_count + 1, 0);
+        entries.resize(items.size());
+
+        if (thread_count <= 1) {
+            for (const auto &item: items) {
+                offsets[key(item) + 1]++;
+            }
+            for (int i = 0; i < key_count; ++i) {
+                offsets[i + 1] += offsets[i];
+            }
+
+            std::vector<int> insert_positions(offsets.begin(), offsets.end() - 1);
+            for (const auto &item: items) {
+                entries[insert_positions[key(item)]++] = to_entry(item);
+            }
+            return;
+        }
+
+        // count items per key
+        std::vector<std::atomic<int> > counters(key_count + 1);
+        parallel_for_chunks(items.size(), thread_count, [&](const size_t begin, const size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                counters[key(items[i]) + 1].fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+
+        // prefix sum: sum up blocks of keys in parallel, then add the preceding block sums
+        const int block_count = std::max(1, std::min(thread_count, key_count));
+        std::vector<int> block_sums(block_count + 1, 0);
+        parallel_for_chunks(block_count, block_count, [&](const size_t block, size_t) {
+            const auto first = static_cast<size_t>(key_count) * block / block_count + 1;
+            const auto last = static_cast<size_t>(key_count) * (block + 1) / block_count + 1;
+            int sum = 0;
+            for (auto i = first; i < last; ++i) {
+                sum += counters[i].load(std::memory_order_relaxed);
+                offsets[i] = sum;
+            }
+            block_sums[block + 1] = sum;
+        });
+        for (int i = 0; i < block_count; ++i) {
+            block_sums[i + 1] += block_sums[i];
+        }
+        parallel_for_chunks(block_count, block_count, [&](const size_t block, size_t) {
+            const auto first = static_cast<size_t>(key_count) * block / block_count + 1;
+            const auto last = static_cast<size_t>(key_count) * (block + 1) / block_count + 1;
+            for (auto i = first; i < last; ++i) {
+                offsets[i] += block_sums[block];
+                // the counters are reused as insert positions for the entries of each key
+                counters[i].store(offsets[i], std::memory_order_relaxed);
+            }
+        });
+        counters[0].store(0, std::memory_order_relaxed);
+
+        // scatter items into their key range
+        parallel_for_chunks(items.size(), thread_count, [&](const size_t begin, const size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                const auto position = counters[key(items[i])].fetch_add(1, std::memory_order_relaxed);
+                entries[position] = to_entry(items[i]);
+            }
+        });
+    }
+} // exercise::two
+
+#endif //CSR_BUILDER_H
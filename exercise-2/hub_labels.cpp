@@ -0,0 +1,372 @@
+//
+// Created by Jost on 17/10/2026.
+//
+
+#include "hub_labels.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "priority_queues.h"
+#include "query_workspace.h"
+#include "thread_pool.h"
+
+namespace exercise::two {
+    // labels are padded to whole cache lines of hubs
+    constexpr int LABEL_ALIGNMENT = 16;
+    // padding hubs sort behind all real hubs, two of them only meet at a distance that counts as unreachable
+    constexpr int PADDING_HUB = std::numeric_limits<int>::max();
+    constexpr int PADDING_DISTANCE = std::numeric_limits<int>::max() / 2;
+
+    constexpr char HUB_LABELS_MAGIC[8] = {'H', 'U', 'B', 'L', 'A', 'B', 'E', 'L'};
+    // increase whenever the file layout changes
+    constexpr uint32_t HUB_LABELS_VERSION = 1;
+    constexpr size_t FILE_ALIGNMENT = 64;
+
+    /// Every array in the file starts at a multiple of FILE_ALIGNMENT, the header takes the first block
+    struct HubLabelsHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t node_count;
+        uint64_t forward_entry_count;
+        uint64_t backward_entry_count;
+    };
+
+    struct LabelEntry {
+        int hub;
+        int distance;
+    };
+
+    static size_t aligned_size(const size_t size) {
+        return (size + FILE_ALIGNMENT - 1) / FILE_ALIGNMENT * FILE_ALIGNMENT;
+    }
+
+    /// Smallest distance over the common hubs of two labels sorted by hub
+    static int merge_labels(const LabelEntry *first_a, const LabelEntry *last_a,
+                            const LabelEntry *first_b, const LabelEntry *last_b) {
+        auto distance = std::numeric_limits<int>::max();
+        while (first_a != last_a && first_b != last_b) {
+            if (first_a->hub < first_b->hub) {
+                ++first_a;
+            } else if (first_b->hub < first_a->hub) {
+                ++first_b;
+            } else {
+                distance = std::min(distance, first_a->distance + first_b->distance);
+                ++first_a;
+                ++first_b;
+            }
+        }
+        return distance;
+    }
+
+    /// Upward search with stall-on-demand from the node, the label holds the settled nodes that weren't stalled
+    static void compute_raw_label(const PackedCHEdges &edges, const int node, const uint32_t direction,
+                                  TimestampedDistances &distances, BinaryHeap &queue,
+                                  std::vector<LabelEntry> &label) {
+        const auto stall_direction = direction == PackedCHEdges::UP ? PackedCHEdges::DOWN : PackedCHEdges::UP;
+        label.clear();
+        distances.reset();
+        queue.reset(edges.get_node_count());
+        distances.set(node, 0);
+        queue.push(node, 0);
+
+        while (!queue.empty()) {
+            const auto [index, distance] = queue.pop();
+
+            // old invalid entry, not removed for performance
+            if (distance > distances.get(index)) {
+                continue;
+            }
+
+            // a higher node reaches this node on a shorter path, so the distance is too long to be useful
+            const auto is_reached_shorter = [&distances, distance](const Edge edge) {
+                const auto higher_distance = distances.get(edge.to);
+                return higher_distance != TimestampedDistances::INFINITE_DISTANCE
+                       && higher_distance + edge.weight < distance;
+            };
+            if (edges.any_edge(index, stall_direction, is_reached_shorter)) {
+                continue;
+            }
+            label.push_back(LabelEntry{index, distance});
+
+            edges.for_each_edge(index, direction, [&](int, const Edge edge) {
+                const auto [neighbour_index, weight] = edge;
+                if (const auto new_distance = distance + weight; new_distance < distances.get(neighbour_index)) {
+                    distances.set(neighbour_index, new_distance);
+                    queue.push(neighbour_index, new_distance);
+                }
+            });
+        }
+
+        std::sort(label.begin(), label.end(), [](const LabelEntry &a, const LabelEntry &b) {
+            return a.hub < b.hub;
+        });
+    }
+
+    HubLabels::HubLabels(const CHGraph &graph, const int thread_count) {
+        const auto &edges = graph.get_edges();
+        m_node_count = graph.get_node_count();
+
+        WorkStealingPool pool(thread_count);
+        std::vector<TimestampedDistances> distances;
+        std::vector<BinaryHeap> queues(pool.get_thread_count());
+        for (int i = 0; i < pool.get_thread_count(); ++i) {
+            distances.emplace_back(m_node_count);
+        }
+
+        std::vector<std::vector<LabelEntry> > raw_forward(m_node_count);
+        std::vector<std::vector<LabelEntry> > raw_backward(m_node_count);
+        pool.parallel_for(m_node_count, [&](const int thread_index, const int node) {
+            compute_raw_label(edges, node, PackedCHEdges::UP, distances[thread_index], queues[thread_index],
+                              raw_forward[node]);
+            compute_raw_label(edges, node, PackedCHEdges::DOWN, distances[thread_index], queues[thread_index],
+                              raw_backward[node]);
+        });
+
+        // the upward searches may reach a hub on a detour, such an entry is shorter over the labels of the hub
+        std::vector<std::vector<LabelEntry> > forward(m_node_count);
+        std::vector<std::vector<LabelEntry> > backward(m_node_count);
+        pool.parallel_for(m_node_count, [&](int, const int node) {
+            const auto &node_forward = raw_forward[node];
+            for (const auto entry: node_forward) {
+                const auto &hub_backward = raw_backward[entry.hub];
+                if (merge_labels(node_forward.data(), node_forward.data() + node_forward.size(),
+                                 hub_backward.data(), hub_backward.data() + hub_backward.size()) == entry.distance) {
+                    forward[node].push_back(entry);
+                }
+            }
+
+            const auto &node_backward = raw_backward[node];
+            for (const auto entry: node_backward) {
+                const auto &hub_forward = raw_forward[entry.hub];
+                if (merge_labels(hub_forward.data(), hub_forward.data() + hub_forward.size(),
+                                 node_backward.data(), node_backward.data() + node_backward.size()) == entry.distance) {
+                    backward[node].push_back(entry);
+                }
+            }
+        });
+        raw_forward = std::vector<std::vector<LabelEntry> >();
+        raw_backward = std::vector<std::vector<LabelEntry> >();
+
+        const auto flatten = [this, &pool](std::vector<std::vector<LabelEntry> > &labels, LabelArrays &arrays) {
+            arrays.offsets.resize(m_node_count + 1);
+            arrays.offsets[0] = 0;
+            for (int node = 0; node < m_node_count; ++node) {
+                const auto size = static_cast<int>(labels[node].size());
+                arrays.offsets[node + 1] = arrays.offsets[node]
+                                           + (size + LABEL_ALIGNMENT - 1) / LABEL_ALIGNMENT * LABEL_ALIGNMENT;
+            }
+            arrays.hubs.assign(arrays.offsets[m_node_count], PADDING_HUB);
+            arrays.distances.assign(arrays.offsets[m_node_count], PADDING_DISTANCE);
+            pool.parallel_for(m_node_count, [&](int, const int node) {
+                for (int i = 0; i < static_cast<int>(labels[node].size()); ++i) {
+                    arrays.hubs[arrays.offsets[node] + i] = labels[node][i].hub;
+                    arrays.distances[arrays.offsets[node] + i] = labels[node][i].distance;
+                }
+                labels[node] = std::vector<LabelEntry>();
+            });
+        };
+        flatten(forward, m_owned_forward);
+        flatten(backward, m_owned_backward);
+
+        m_owned_node_index_map.resize(m_node_count);
+        for (int node = 0; node < m_node_count; ++node) {
+            m_owned_node_index_map[node] = graph.get_node_index(node);
+        }
+
+        m_node_index_map = m_owned_node_index_map.data();
+        m_forward = Labels{m_owned_forward.offsets.data(), m_owned_forward.hubs.data(),
+                           m_owned_forward.distances.data()};
+        m_backward = Labels{m_owned_backward.offsets.data(), m_owned_backward.hubs.data(),
+                            m_owned_backward.distances.data()};
+    }
+
+    bool HubLabels::save(const std::string &file_name) const {
+        std::ofstream file(file_name, std::ios::out | std::ios::binary | std::ios::trunc);
+        const auto forward_entry_count = m_forward.offsets[m_node_count];
+        const auto backward_entry_count = m_backward.offsets[m_node_count];
+
+        const auto write_block = [&file](const void *data, const size_t size) {
+            static constexpr char padding[FILE_ALIGNMENT] = {};
+            file.write(static_cast<const char *>(data), static_cast<std::streamsize>(size));
+            file.write(padding, static_cast<std::streamsize>(aligned_size(size) - size));
+        };
+
+        HubLabelsHeader header{};
+        std::memcpy(header.magic, HUB_LABELS_MAGIC, sizeof(header.magic));
+        header.version = HUB_LABELS_VERSION;
+        header.node_count = static_cast<uint32_t>(m_node_count);
+        header.forward_entry_count = static_cast<uint64_t>(forward_entry_count);
+        header.backward_entry_count = static_cast<uint64_t>(backward_entry_count);
+        write_block(&header, sizeof(header));
+
+        write_block(m_node_index_map, m_node_count * sizeof(int));
+        for (const auto &[labels, entry_count]: {std::pair{m_forward, forward_entry_count},
+                                                 std::pair{m_backward, backward_entry_count}}) {
+            write_block(labels.offsets, (m_node_count + 1) * sizeof(int));
+            write_block(labels.hubs, entry_count * sizeof(int));
+            write_block(labels.distances, entry_count * sizeof(int));
+        }
+
+        file.close();
+        return !file.fail();
+    }
+
+    std::optional<HubLabels> HubLabels::from_file(const std::string &file_name) {
+        MappedFile file(file_name);
+        if (!file.is_open() || file.size() < sizeof(HubLabelsHeader))
+            return std::nullopt;
+
+        HubLabelsHeader header{};
+        std::memcpy(&header, file.data(), sizeof(header));
+        if (std::memcmp(header.magic, HUB_LABELS_MAGIC, sizeof(header.magic)) != 0
+            || header.version != HUB_LABELS_VERSION)
+            return std::nullopt;
+
+        const auto node_count = static_cast<size_t>(header.node_count);
+        const auto offsets_size = aligned_size((node_count + 1) * sizeof(int));
+        const auto expected_size = aligned_size(sizeof(header)) + aligned_size(node_count * sizeof(int))
+                                   + 2 * offsets_size
+                                   + 2 * aligned_size(header.forward_entry_count * sizeof(int))
+                                   + 2 * aligned_size(header.backward_entry_count * sizeof(int));
+        if (file.size() != expected_size)
+            return std::nullopt;
+
+        // the mapping starts at a page boundary, so all arrays stay cache aligned
+        const auto *cursor = file.data() + aligned_size(sizeof(header));
+        const auto next_array = [&cursor](const size_t size) {
+            const auto *array = reinterpret_cast<const int *>(cursor);
+            cursor += aligned_size(size * sizeof(int));
+            return array;
+        };
+
+        HubLabels labels;
+        labels.m_node_count = static_cast<int>(node_count);
+        labels.m_node_index_map = next_array(node_count);
+        labels.m_forward.offsets = next_array(node_count + 1);
+        labels.m_forward.hubs = next_array(header.forward_entry_count);
+        labels.m_forward.distances = next_array(header.forward_entry_count);
+        labels.m_backward.offsets = next_array(node_count + 1);
+        labels.m_backward.hubs = next_array(header.backward_entry_count);
+        labels.m_backward.distances = next_array(header.backward_entry_count);
+        if (labels.m_forward.offsets[node_count] != static_cast<int>(header.forward_entry_count)
+            || labels.m_backward.offsets[node_count] != static_cast<int>(header.backward_entry_count))
+            return std::nullopt;
+
+        labels.m_file = std::move(file);
+        return labels;
+    }
+
+    /// Smallest distance over the common hubs, the labels are padded to multiples of four entries
+    static int merge_scalar(const int *hubs_a, const int *distances_a, const int count_a,
+                            const int *hubs_b, const int *distances_b, const int count_b) {
+        auto distance = std::numeric_limits<int>::max();
+        int i = 0;
+        int j = 0;
+        while (i < count_a && j < count_b) {
+            if (hubs_a[i] < hubs_b[j]) {
+                ++i;
+            } else if (hubs_b[j] < hubs_a[i]) {
+                ++j;
+            } else {
+                distance = std::min(distance, distances_a[i++] + distances_b[j++]);
+            }
+        }
+        return distance;
+    }
+
+#if defined(__SSE2__)
+    /// Compares a block of four hubs of each label with all four rotations of the other block and keeps the smallest
+    /// sum of the matching lanes without branching. The block with the smaller last hub can't match anything behind
+    /// the other block and is skipped
+    static int merge_simd(const int *hubs_a, const int *distances_a, const int count_a,
+                          const int *hubs_b, const int *distances_b, const int count_b) {
+        const auto infinite = _mm_set1_epi32(std::numeric_limits<int>::max());
+        auto best = infinite;
+        int i = 0;
+        int j = 0;
+        while (i < count_a && j < count_b) {
+            const auto block_a = _mm_load_si128(reinterpret_cast<const __m128i *>(hubs_a + i));
+            const auto distance_a = _mm_load_si128(reinterpret_cast<const __m128i *>(distances_a + i));
+            auto block_b = _mm_load_si128(reinterpret_cast<const __m128i *>(hubs_b + j));
+            auto distance_b = _mm_load_si128(reinterpret_cast<const __m128i *>(distances_b + j));
+            for (int rotation = 0; rotation < 4; ++rotation) {
+                // lanes without a common hub may overflow, they are replaced by infinity
+                const auto equal = _mm_cmpeq_epi32(block_a, block_b);
+                const auto sum = _mm_add_epi32(distance_a, distance_b);
+                const auto candidate = _mm_or_si128(_mm_and_si128(equal, sum), _mm_andnot_si128(equal, infinite));
+                const auto smaller = _mm_cmplt_epi32(candidate, best);
+                best = _mm_or_si128(_mm_and_si128(smaller, candidate), _mm_andnot_si128(smaller, best));
+                block_b = _mm_shuffle_epi32(block_b, _MM_SHUFFLE(0, 3, 2, 1));
+                distance_b = _mm_shuffle_epi32(distance_b, _MM_SHUFFLE(0, 3, 2, 1));
+            }
+
+            const auto last_a = hubs_a[i + 3];
+            const auto last_b = hubs_b[j + 3];
+            i += (last_a <= last_b) * 4;
+            j += (last_b <= last_a) * 4;
+        }
+
+        alignas(16) int lanes[4];
+        _mm_store_si128(reinterpret_cast<__m128i *>(lanes), best);
+        return std::min(std::min(lanes[0], lanes[1]), std::min(lanes[2], lanes[3]));
+    }
+#endif
+
+    int HubLabels::compute_shortest_path(const int source, const int target, const bool simd_merge) const {
+        if (source < 0 || source >= m_node_count || target < 0 || target >= m_node_count)
+            return -1;
+
+        const auto source_index = m_node_index_map[source];
+        const auto target_index = m_node_index_map[target];
+        const auto forward_offset = m_forward.offsets[source_index];
+        const auto backward_offset = m_backward.offsets[target_index];
+        const auto forward_count = m_forward.offsets[source_index + 1] - forward_offset;
+        const auto backward_count = m_backward.offsets[target_index + 1] - backward_offset;
+
+        auto merge = merge_scalar;
+#if defined(__SSE2__)
+        if (simd_merge) {
+            merge = merge_simd;
+        }
+#endif
+        const auto distance = merge(m_forward.hubs + forward_offset, m_forward.distances + forward_offset,
+                                    forward_count, m_backward.hubs + backward_offset,
+                                    m_backward.distances + backward_offset, backward_count);
+
+        // padding hubs only meet each other
+        if (distance >= PADDING_DISTANCE)
+            return -1;
+
+        return distance;
+    }
+
+    int HubLabels::get_node_count() const {
+        return m_node_count;
+    }
+
+    long long HubLabels::get_entry_count() const {
+        long long count = 0;
+        for (const auto &labels: {m_forward, m_backward}) {
+            for (int node = 0; node < m_node_count; ++node) {
+                const auto first = labels.offsets[node];
+                const auto last = labels.offsets[node + 1];
+                count += std::count_if(labels.hubs + first, labels.hubs + last,
+                                       [](const int hub) { return hub != PADDING_HUB; });
+            }
+        }
+        return count;
+    }
+
+    size_t HubLabels::get_memory_size() const {
+        const auto entries = static_cast<size_t>(m_forward.offsets[m_node_count] + m_backward.offsets[m_node_count]);
+        return (3 * static_cast<size_t>(m_node_count) + 2) * sizeof(int) + entries * 2 * sizeof(int);
+    }
+} // exercise::two
@@ -0,0 +1,118 @@
+//
+// Created by Jost on 17/10/2026.
+//
+
+#ifndef HUB_LABELS_H
+#define HUB_LABELS_H
+
+#include <cstddef>
+#include <new>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ch_graph.h"
+#include "mapped_file.h"
+
+namespace exercise::two {
+    /// Allocates every array at the start of a cache line
+    template<typename T>
+    struct CacheAlignedAllocator {
+        using value_type = T;
+        static constexpr std::size_t ALIGNMENT = 64;
+
+        CacheAlignedAllocator() = default;
+
+        template<typename U>
+        explicit CacheAlignedAllocator(const CacheAlignedAllocator<U> &) {
+        }
+
+        T *allocate(const std::size_t count) {
+            return static_cast<T *>(::operator new(count * sizeof(T), std::align_val_t(ALIGNMENT)));
+        }
+
+        void deallocate(T *pointer, std::size_t) {
+            ::operator delete(pointer, std::align_val_t(ALIGNMENT));
+        }
+
+        bool operator==(const CacheAlignedAllocator &) const {
+            return true;
+        }
+
+        bool operator!=(const CacheAlignedAllocator &) const {
+            return false;
+        }
+    };
+
+    /// Hub labels computed from the order of a contraction hierarchy. The forward label of a node holds the
+    /// distances to the nodes its upward search reaches, the backward label the distances from them, so a shortest
+    /// path from s to t is the smallest sum over the hubs in both the forward label of s and the backward label
+    /// of t. Hubs are CH node indices, every label is sorted by hub and padded to whole cache lines, so a query
+    /// is a merge of two short sorted arrays. The label file has the same layout as the memory and is used
+    /// directly from a read-only mapping.
+    class HubLabels {
+    public:
+        /// One upward search per node and direction with stall-on-demand, the entries whose distance is longer
+        /// than the one found over the labels of hub and node are pruned afterwards
+        explicit HubLabels(const CHGraph &graph,
+                           int thread_count = static_cast<int>(std::thread::hardware_concurrency()));
+
+        HubLabels(HubLabels &&) noexcept = default;
+
+        HubLabels &operator=(HubLabels &&) noexcept = default;
+
+        HubLabels(const HubLabels &) = delete;
+
+        HubLabels &operator=(const HubLabels &) = delete;
+
+        /// Maps a file written by save(), returns nothing if the file is missing, outdated or truncated
+        static std::optional<HubLabels> from_file(const std::string &file_name);
+
+        [[nodiscard]] bool save(const std::string &file_name) const;
+
+        /// Distance from source to target, -1 if there is no path. The SIMD merge compares blocks of four hubs of
+        /// both labels at once, it falls back to the scalar merge where SSE2 isn't available
+        [[nodiscard]] int compute_shortest_path(int source, int target, bool simd_merge = true) const;
+
+        [[nodiscard]] int get_node_count() const;
+
+        /// Entries without the padding of forward and backward labels together
+        [[nodiscard]] long long get_entry_count() const;
+
+        /// Bytes of all label arrays including the padding
+        [[nodiscard]] size_t get_memory_size() const;
+
+    private:
+        template<typename T>
+        using AlignedVector = std::vector<T, CacheAlignedAllocator<T> >;
+
+        /// Labels of one direction, the label of a node is at [offsets[node], offsets[node + 1])
+        struct Labels {
+            const int *offsets = nullptr;
+            const int *hubs = nullptr;
+            const int *distances = nullptr;
+        };
+
+        /// Arrays of the labels computed in this process, empty for labels loaded from a file
+        struct LabelArrays {
+            AlignedVector<int> offsets;
+            AlignedVector<int> hubs;
+            AlignedVector<int> distances;
+        };
+
+        int m_node_count = 0;
+        const int *m_node_index_map = nullptr;
+        Labels m_forward;
+        Labels m_backward;
+
+        AlignedVector<int> m_owned_node_index_map;
+        LabelArrays m_owned_forward;
+        LabelArrays m_owned_backward;
+        std::optional<MappedFile> m_file;
+
+        HubLabels() = default;
+    };
+} // exercise::two
+
+#endif //HUB_LABELS_H
@@ -3,59 +3,634 @@
 //
 
 #include <iostream>
+#include <iomanip>
 #include <filesystem>
+#include <random>
 #include "Stopwatch.h"
+#include "cch_graph.h"
 #include "ch_graph.h"
+#include "csr_builder.h"
+#include "hub_labels.h"
+#include "phast.h"
+#include "priority_queues.h"
 
 namespace fs = std::filesystem;
 
 constexpr int CH_ITERATIONS = 1000;
+constexpr unsigned COMPARISON_SEED = 42;
+constexpr int DEFAULT_TABLE_SIZE = 1000;
+constexpr int DEFAULT_PHAST_SOURCE_COUNT = 64;
+constexpr int CCH_CHECKED_QUERIES = 100;
+constexpr int HUB_LABEL_QUERIES = 1000;
 
 const std::string default_graph_file_name = "graph.fmi";
 const std::string default_query_file_name = "queries.txt";
 const std::string default_result_file_name = "result.txt";
+const std::string snapshot_file_extension = ".snapshot";
+const std::string hub_labels_file_extension = ".labels";
+const std::string ch_file_extension = ".ch";
+
+static void run_query_benchmark(const exercise::two::CHGraph &graph) {
+    std::cout << "Query graph with " << graph.get_edge_count() << " edges uses "
+            << graph.get_query_graph_size() / 1024 << "KB\n" << std::endl;
+    std::cout << "Calculating " << CH_ITERATIONS << " shortest path queries:" << std::endl;
+    exercise::two::CHQueryWorkspace<> workspace(graph.get_node_count());
+    std::vector<int> path;
+    auto sw = Stopwatch<std::chrono::microseconds>::Start();
+    long long overall_time = 0;
+    long long unpack_time = 0;
+    long long path_nodes = 0;
+    for (int i = 0; i < CH_ITERATIONS; ++i) {
+        const int start = std::rand() % graph.get_node_count();
+        const int end = std::rand() % graph.get_node_count();
+
+        sw.Restart();
+        const auto dist = graph.compute_shortest_path(start, end, workspace);
+        overall_time += sw.Split();
+
+        // the shortcuts of the found path are unpacked separately, so the distance query is timed on its own
+        sw.Restart();
+        graph.unpack_path(workspace, path);
+        unpack_time += sw.Split();
+        path_nodes += static_cast<long long>(path.size());
+    }
+    std::cout << "Computed in average of " << overall_time / CH_ITERATIONS << "us" << std::endl;
+    std::cout << "Unpacked paths with " << path_nodes / CH_ITERATIONS << " nodes in average of "
+            << unpack_time / CH_ITERATIONS << "us\n" << std::endl;
+}
+
+static void save_snapshot(const exercise::two::CHGraph &graph, const std::string &graph_file_name) {
+    const auto snapshot_file_name = graph_file_name + snapshot_file_extension;
+    auto sw = Stopwatch<std::chrono::milliseconds>::Start();
+    if (!graph.save(snapshot_file_name)) {
+        std::cout << "Couldn't write '" << snapshot_file_name << "' file!" << std::endl;
+        return;
+    }
+    std::cout << "Snapshot written to '" << snapshot_file_name << "' in " << sw.Stop() << "ms, load it with "
+            << "'-snapshot " << snapshot_file_name << "'\n" << std::endl;
+}
+
+/// Generates the hierarchy with every node ordering and runs the same random queries on each of them
+static int run_ordering_comparison(const std::string &graph_file_name) {
+    using exercise::two::NodeOrdering;
+    const std::pair<std::string, NodeOrdering> orderings[] = {
+        {"Independent set", NodeOrdering::IndependentSet},
+        {"Priority queue", NodeOrdering::Priority},
+    };
+
+    for (const auto &[name, ordering]: orderings) {
+        std::fstream graph_file(graph_file_name, std::ios::in);
+        if (!graph_file.is_open()) {
+            std::cout << "Couldn't open '" << graph_file_name << "' file!" << std::endl;
+            return 1;
+        }
+
+        auto sw = Stopwatch<std::chrono::milliseconds>::Start();
+        exercise::two::CHPreprocessingOptions options;
+        options.ordering = ordering;
+        const auto graph = exercise::two::CHGraph(std::move(graph_file), false, options);
+        const auto preprocessing_time = sw.Stop();
+
+        std::mt19937 generator(COMPARISON_SEED);
+        std::uniform_int_distribution random_node(0, graph.get_node_count() - 1);
+        exercise::two::CHQueryWorkspace<> workspace(graph.get_node_count());
+        auto query_sw = Stopwatch<std::chrono::microseconds>::Start();
+        long long query_time = 0;
+        long long settled_nodes = 0;
+        for (int i = 0; i < CH_ITERATIONS; ++i) {
+            const int start = random_node(generator);
+            const int end = random_node(generator);
+
+            query_sw.Restart();
+            const auto dist = graph.compute_shortest_path(start, end, workspace);
+            query_time += query_sw.Split();
+            settled_nodes += workspace.settled_nodes;
+        }
+
+        std::cout << "[BENCHMARK] " << name << " ordering" << std::endl;
+        std::cout << "[BENCHMARK] Preprocessing:      " << std::setw(12) << preprocessing_time << " ms" << std::endl;
+        std::cout << "[BENCHMARK] Query graph edges:  " << std::setw(12) << graph.get_edge_count() << std::endl;
+        std::cout << "[BENCHMARK] Query graph size:   " << std::setw(12) << graph.get_query_graph_size() / 1024
+                << " KB" << std::endl;
+        std::cout << "[BENCHMARK] Query time:         " << std::setw(12) << query_time / CH_ITERATIONS << " us"
+                << std::endl;
+        std::cout << "[BENCHMARK] Settled nodes:      " << std::setw(12) << settled_nodes / CH_ITERATIONS << "\n"
+                << std::endl;
+    }
+    return 0;
+}
+
+/// Runs the queries of the file, one 'source target' pair per line, with and without stall-on-demand
+static int run_search_space_comparison(const exercise::two::CHGraph &graph, const std::string &query_file_name) {
+    std::ifstream query_file(query_file_name);
+    if (!query_file.is_open()) {
+        std::cout << "Couldn't open '" << query_file_name << "' file!" << std::endl;
+        return 1;
+    }
+    std::vector<std::pair<int, int> > queries;
+    int source, target;
+    while (query_file >> source >> target) {
+        queries.emplace_back(source, target);
+    }
+    if (queries.empty()) {
+        std::cout << "No queries in '" << query_file_name << "'" << std::endl;
+        return 1;
+    }
+    const auto query_count = static_cast<long long>(queries.size());
+
+    exercise::two::CHQueryWorkspace<> workspace(graph.get_node_count());
+    for (const bool stall_on_demand: {false, true}) {
+        auto sw = Stopwatch<std::chrono::microseconds>::Start();
+        long long query_time = 0;
+        long long settled_nodes = 0;
+        long long stalled_nodes = 0;
+        for (const auto &[start, end]: queries) {
+            sw.Restart();
+            const auto dist = graph.compute_shortest_path(start, end, workspace, stall_on_demand);
+            query_time += sw.Split();
+            settled_nodes += workspace.settled_nodes;
+            stalled_nodes += workspace.stalled_nodes;
+        }
+
+        std::cout << "[BENCHMARK] " << (stall_on_demand ? "With" : "Without") << " stall-on-demand, "
+                << query_count << " queries" << std::endl;
+        std::cout << "[BENCHMARK] Query time:         " << std::setw(12) << query_time / query_count << " us"
+                << std::endl;
+        std::cout << "[BENCHMARK] Settled nodes:      " << std::setw(12) << settled_nodes / query_count << std::endl;
+        std::cout << "[BENCHMARK] Stalled nodes:      " << std::setw(12) << stalled_nodes / query_count << "\n"
+                << std::endl;
+    }
+    return 0;
+}
+
+/// Computes a random table_size x table_size distance table with the buckets and with single queries
+static void run_distance_table_benchmark(const exercise::two::CHGraph &graph, const int table_size) {
+    std::mt19937 generator(COMPARISON_SEED);
+    std::uniform_int_distribution random_node(0, graph.get_node_count() - 1);
+    std::vector<int> sources(table_size);
+    std::vector<int> targets(table_size);
+    for (int i = 0; i < table_size; ++i) {
+        sources[i] = random_node(generator);
+        targets[i] = random_node(generator);
+    }
+
+    auto sw = Stopwatch<std::chrono::milliseconds>::Start();
+    const auto table = graph.compute_distance_table(sources, targets);
+    const auto table_time = sw.Stop();
+
+    sw.Restart();
+    exercise::two::CHQueryWorkspace<> workspace(graph.get_node_count());
+    long long mismatches = 0;
+    for (int i = 0; i < table_size; ++i) {
+        for (int j = 0; j < table_size; ++j) {
+            if (graph.compute_shortest_path(sources[i], targets[j], workspace) != table[i * table_size + j]) {
+                mismatches++;
+            }
+        }
+    }
+    const auto single_time = sw.Stop();
+
+    std::cout << "[BENCHMARK] " << table_size << " x " << table_size << " distance table" << std::endl;
+    std::cout << "[BENCHMARK] Bucket search:      " << std::setw(12) << table_time << " ms" << std::endl;
+    std::cout << "[BENCHMARK] Single queries:     " << std::setw(12) << single_time << " ms" << std::endl;
+    std::cout << "[BENCHMARK] Mismatches:         " << std::setw(12) << mismatches << std::endl;
+}
+
+/// Plain Dijkstra from source to all nodes over all edges of the hierarchy, the shortcuts don't change the distances
+static std::vector<int> compute_dijkstra_distances(const exercise::two::CHGraph &graph,
+                                                   const std::vector<int> &offsets,
+                                                   const std::vector<exercise::two::Edge> &edges, const int source) {
+    std::vector<int> distances(graph.get_node_count(), std::numeric_limits<int>::max());
+    exercise::two::BinaryHeap queue;
+    distances[graph.get_node_index(source)] = 0;
+    queue.push(graph.get_node_index(source), 0);
+    while (!queue.empty()) {
+        const auto [index, distance] = queue.pop();
+        if (distance > distances[index])
+            continue;
+
+        for (int i = offsets[index]; i < offsets[index + 1]; ++i) {
+            const auto [neighbour_index, weight] = edges[i];
+            if (distance + weight < distances[neighbour_index]) {
+                distances[neighbour_index] = distance + weight;
+                queue.push(neighbour_index, distance + weight);
+            }
+        }
+    }
+
+    std::vector<int> distances_by_id(graph.get_node_count());
+    for (int index = 0; index < graph.get_node_count(); ++index) {
+        distances_by_id[graph.get_node_id(index)] = distances[index] == std::numeric_limits<int>::max()
+                                                        ? -1
+                                                        : distances[index];
+    }
+    return distances_by_id;
+}
+
+/// Compares one-to-all distances of random sources with one Dijkstra per source and PHAST with 1 to 16 lanes
+static void run_phast_benchmark(const exercise::two::CHGraph &graph, const int source_count) {
+    using exercise::two::Edge;
+    std::mt19937 generator(COMPARISON_SEED);
+    std::uniform_int_distribution random_node(0, graph.get_node_count() - 1);
+    std::vector<int> sources(source_count);
+    for (auto &source: sources) {
+        source = random_node(generator);
+    }
+
+    // the CH only stores the down edges at their targets, the forward graph of the hierarchy is rebuilt for Dijkstra
+    struct ForwardEdge {
+        int from;
+        Edge edge;
+    };
+    std::vector<ForwardEdge> forward_edges;
+    const auto &ch_edges = graph.get_edges();
+    for (int index = 0; index < graph.get_node_count(); ++index) {
+        ch_edges.for_each_edge(index, exercise::two::PackedCHEdges::UP, [&](int, const Edge edge) {
+            forward_edges.push_back(ForwardEdge{index, edge});
+        });
+        ch_edges.for_each_edge(index, exercise::two::PackedCHEdges::DOWN, [&](int, const Edge edge) {
+            forward_edges.push_back(ForwardEdge{edge.to, Edge{index, edge.weight}});
+        });
+    }
+    std::vector<int> offsets;
+    std::vector<Edge> edges;
+    exercise::two::build_csr(forward_edges, graph.get_node_count(), offsets, edges,
+                             [](const ForwardEdge &edge) { return edge.from; },
+                             [](const ForwardEdge &edge) { return edge.edge; }, 1);
+
+    auto sw = Stopwatch<std::chrono::milliseconds>::Start();
+    std::vector<int> dijkstra_distances;
+    for (const auto source: sources) {
+        const auto distances = compute_dijkstra_distances(graph, offsets, edges, source);
+        dijkstra_distances.insert(dijkstra_distances.end(), distances.begin(), distances.end());
+    }
+    const auto dijkstra_time = sw.Stop();
+
+    const exercise::two::PHAST phast(graph);
+    const auto run_phast = [&](const std::string &name, const auto &compute_distances) {
+        sw.Restart();
+        const auto distances = compute_distances();
+        const auto time = sw.Stop();
+        std::cout << "[BENCHMARK] " << std::left << std::setw(19) << name + ":" << std::right << std::setw(12)
+                << time << " ms" << (distances == dijkstra_distances ? "" : " [WRONG DISTANCES]") << std::endl;
+    };
+
+    std::cout << "[BENCHMARK] One-to-all distances from " << source_count << " sources" << std::endl;
+    std::cout << "[BENCHMARK] Dijkstra:          " << std::setw(12) << dijkstra_time << " ms" << std::endl;
+    run_phast("PHAST", [&]() { return phast.compute_distances<1>(sources); });
+    run_phast("PHAST 4 lanes", [&]() { return phast.compute_distances<4>(sources); });
+    run_phast("PHAST 8 lanes", [&]() { return phast.compute_distances<8>(sources); });
+    run_phast("PHAST 16 lanes", [&]() { return phast.compute_distances<16>(sources); });
+}
+
+/// Plain Dijkstra from source to target on the fmi edges with the given weights
+static int compute_dijkstra_distance(const std::vector<int> &offsets, const std::vector<exercise::two::Edge> &edges,
+                                     const int source, const int target) {
+    std::vector<int> distances(offsets.size() - 1, std::numeric_limits<int>::max());
+    exercise::two::BinaryHeap queue;
+    distances[source] = 0;
+    queue.push(source, 0);
+    while (!queue.empty()) {
+        const auto [node, distance] = queue.pop();
+        if (distance > distances[node])
+            continue;
+        if (node == target)
+            return distance;
+
+        for (int i = offsets[node]; i < offsets[node + 1]; ++i) {
+            const auto [neighbour, weight] = edges[i];
+            if (distance + weight < distances[neighbour]) {
+                distances[neighbour] = distance + weight;
+                queue.push(neighbour, distance + weight);
+            }
+        }
+    }
+    return -1;
+}
+
+/// Builds the CCH once and customizes it with the weights of the file and with randomly congested weights,
+/// the queries of both metrics are checked against Dijkstra
+static int run_cch_benchmark(const std::string &graph_file_name) {
+    using exercise::two::Edge;
+    using exercise::two::FMIEdge;
+    std::fstream graph_file(graph_file_name, std::ios::in);
+    if (!graph_file.is_open()) {
+        std::cout << "Couldn't open '" << graph_file_name << "' file!" << std::endl;
+        return 1;
+    }
+    std::vector<FMIEdge> edges;
+    const auto node_count = exercise::two::parse_fmi_file(std::move(graph_file), edges);
+
+    auto sw = Stopwatch<std::chrono::milliseconds>::Start();
+    exercise::two::CCHGraph graph(node_count, edges);
+    const auto preprocessing_time = sw.Stop();
+    std::cout << "[BENCHMARK] Nodes:              " << std::setw(12) << node_count << std::endl;
+    std::cout << "[BENCHMARK] Arcs:               " << std::setw(12) << graph.get_arc_count() << std::endl;
+    std::cout << "[BENCHMARK] Tree height:        " << std::setw(12) << graph.get_elimination_tree_height()
+            << std::endl;
+    std::cout << "[BENCHMARK] Preprocessing:      " << std::setw(12) << preprocessing_time << " ms\n" << std::endl;
+
+    std::mt19937 generator(COMPARISON_SEED);
+    std::vector<int> file_weights(edges.size());
+    std::vector<int> congested_weights(edges.size());
+    std::uniform_real_distribution congestion(1.0, 2.0);
+    for (size_t i = 0; i < edges.size(); ++i) {
+        file_weights[i] = edges[i].weight;
+        congested_weights[i] = static_cast<int>(edges[i].weight * congestion(generator));
+    }
+
+    const std::pair<std::string, const std::vector<int> &> metrics[] = {
+        {"File", file_weights},
+        {"Congested", congested_weights},
+    };
+    std::uniform_int_distribution random_node(0, node_count - 1);
+    for (const auto &[name, weights]: metrics) {
+        sw.Restart();
+        graph.customize(weights);
+        const auto customization_time = sw.Stop();
+
+        struct WeightedEdge {
+            int from;
+            Edge edge;
+        };
+        std::vector<WeightedEdge> weighted_edges(edges.size());
+        for (size_t i = 0; i < edges.size(); ++i) {
+            weighted_edges[i] = WeightedEdge{edges[i].from, Edge{edges[i].to, weights[i]}};
+        }
+        std::vector<int> offsets;
+        std::vector<Edge> dijkstra_edges;
+        exercise::two::build_csr(weighted_edges, node_count, offsets, dijkstra_edges,
+                                 [](const WeightedEdge &edge) { return edge.from; },
+                                 [](const WeightedEdge &edge) { return edge.edge; }, 1);
+
+        auto query_sw = Stopwatch<std::chrono::microseconds>::Start();
+        long long query_time = 0;
+        int mismatches = 0;
+        for (int i = 0; i < CH_ITERATIONS; ++i) {
+            const int start = random_node(generator);
+            const int end = random_node(generator);
+
+            query_sw.Restart();
+            const auto dist = graph.compute_shortest_path(start, end);
+            query_time += query_sw.Split();
+            if (i < CCH_CHECKED_QUERIES && dist != compute_dijkstra_distance(offsets, dijkstra_edges, start, end)) {
+                mismatches++;
+            }
+        }
+
+        std::cout << "[BENCHMARK] " << name << " weights" << std::endl;
+        std::cout << "[BENCHMARK] Customization:      " << std::setw(12) << customization_time << " ms" << std::endl;
+        std::cout << "[BENCHMARK] Query time:         " << std::setw(12) << query_time / CH_ITERATIONS << " us"
+                << std::endl;
+        std::cout << "[BENCHMARK] Mismatches:         " << std::setw(12) << mismatches << " of "
+                << CCH_CHECKED_QUERIES << "\n" << std::endl;
+    }
+    return 0;
+}
+
+/// Keeps the generated hierarchy as a .ch file, so the preprocessing doesn't have to run again
+static void save_ch_file(const exercise::two::CHGraph &graph, const std::string &graph_file_name) {
+    const auto ch_file_name = graph_file_name + ch_file_extension;
+    auto sw = Stopwatch<std::chrono::milliseconds>::Start();
+    if (!graph.save_ch(ch_file_name)) {
+        std::cout << "Couldn't write '" << ch_file_name << "' file!" << std::endl;
+        return;
+    }
+    std::cout << "CH graph written to '" << ch_file_name << "' in " << sw.Stop() << "ms, load it with "
+            << "'-ch " << ch_file_name << "'\n" << std::endl;
+}
+
+/// Compares the latency of the sequential bidirectional query with the one running both directions in parallel
+static void run_parallel_query_comparison(const exercise::two::CHGraph &graph) {
+    std::mt19937 generator(COMPARISON_SEED);
+    std::uniform_int_distribution random_node(0, graph.get_node_count() - 1);
+    std::vector<std::pair<int, int> > queries(CH_ITERATIONS);
+    for (auto &[source, target]: queries) {
+        source = random_node(generator);
+        target = random_node(generator);
+    }
+
+    exercise::two::CHQueryWorkspace<> workspace(graph.get_node_count());
+    std::vector<int> distances;
+    long long sequential_settled_nodes = 0;
+    auto sw = Stopwatch<std::chrono::microseconds>::Start();
+    for (const auto [source, target]: queries) {
+        distances.push_back(graph.compute_shortest_path(source, target, workspace));
+        sequential_settled_nodes += workspace.settled_nodes;
+    }
+    const auto sequential_time = sw.Stop();
+
+    exercise::two::WorkStealingPool pool(2);
+    long long parallel_settled_nodes = 0;
+    long long mismatches = 0;
+    sw.Restart();
+    for (int i = 0; i < CH_ITERATIONS; ++i) {
+        if (graph.compute_shortest_path_parallel(queries[i].first, queries[i].second, workspace, pool)
+            != distances[i]) {
+            mismatches++;
+        }
+        parallel_settled_nodes += workspace.settled_nodes;
+    }
+    const auto parallel_time = sw.Stop();
+
+    std::cout << "[BENCHMARK] Average of " << CH_ITERATIONS << " queries" << std::endl;
+    std::cout << "[BENCHMARK] Sequential query:  " << std::setw(12)
+            << static_cast<double>(sequential_time) / CH_ITERATIONS << " us, "
+            << sequential_settled_nodes / CH_ITERATIONS << " settled nodes" << std::endl;
+    std::cout << "[BENCHMARK] Parallel query:    " << std::setw(12)
+            << static_cast<double>(parallel_time) / CH_ITERATIONS << " us, "
+            << parallel_settled_nodes / CH_ITERATIONS << " settled nodes" << std::endl;
+    std::cout << "[BENCHMARK] Mismatches:        " << std::setw(12) << mismatches << std::endl;
+}
+
+/// Computes hub labels from the hierarchy, saves and maps them and compares their queries with the CH query
+static int run_hub_labels_benchmark(const exercise::two::CHGraph &graph, const std::string &labels_file_name) {
+    std::cout << "Computing hub labels:" << std::endl;
+    auto sw = Stopwatch<std::chrono::milliseconds>::Start();
+    const exercise::two::HubLabels labels(graph);
+    const auto labels_time = sw.Stop();
+    std::cout << "Computed " << labels.get_entry_count() << " label entries in " << labels_time << "ms, "
+            << labels.get_entry_count() / (2 * std::max(1, labels.get_node_count())) << " hubs per label, "
+            << labels.get_memory_size() / 1024 << "KB\n" << std::endl;
+
+    if (!labels.save(labels_file_name)) {
+        std::cout << "Couldn't write '" << labels_file_name << "' file!" << std::endl;
+        return 1;
+    }
+    sw.Restart();
+    const auto mapped_labels = exercise::two::HubLabels::from_file(labels_file_name);
+    if (!mapped_labels) {
+        std::cout << "Couldn't load '" << labels_file_name << "' file!" << std::endl;
+        return 1;
+    }
+    const auto map_time = sw.Stop();
+
+    std::mt19937 generator(COMPARISON_SEED);
+    std::uniform_int_distribution random_node(0, graph.get_node_count() - 1);
+    std::vector<std::pair<int, int> > queries(HUB_LABEL_QUERIES);
+    for (auto &[source, target]: queries) {
+        source = random_node(generator);
+        target = random_node(generator);
+    }
+
+    auto query_sw = Stopwatch<std::chrono::microseconds>::Start();
+    exercise::two::CHQueryWorkspace<> workspace(graph.get_node_count());
+    std::vector<int> ch_distances;
+    for (const auto [source, target]: queries) {
+        ch_distances.push_back(graph.compute_shortest_path(source, target, workspace));
+    }
+    const auto ch_time = query_sw.Stop();
+
+    const auto run_labels = [&](const std::string &name, const auto &compute_distance) {
+        long long mismatches = 0;
+        query_sw.Restart();
+        for (int i = 0; i < HUB_LABEL_QUERIES; ++i) {
+            if (compute_distance(queries[i].first, queries[i].second) != ch_distances[i]) {
+                mismatches++;
+            }
+        }
+        const auto time = query_sw.Stop();
+        std::cout << "[BENCHMARK] " << std::left << std::setw(19) << name + ":" << std::right << std::setw(12)
+                << static_cast<double>(time) / HUB_LABEL_QUERIES << " us"
+                << (mismatches == 0 ? "" : " [" + std::to_string(mismatches) + " WRONG DISTANCES]") << std::endl;
+    };
+
+    std::cout << "[BENCHMARK] Average of " << HUB_LABEL_QUERIES << " queries" << std::endl;
+    std::cout << "[BENCHMARK] CH query:          " << std::setw(12)
+            << static_cast<double>(ch_time) / HUB_LABEL_QUERIES << " us" << std::endl;
+    run_labels("Labels", [&](const int s, const int t) { return labels.compute_shortest_path(s, t, false); });
+    run_labels("Labels SIMD", [&](const int s, const int t) { return labels.compute_shortest_path(s, t); });
+    run_labels("Mapped labels", [&](const int s, const int t) { return mapped_labels->compute_shortest_path(s, t); });
+    std::cout << "[BENCHMARK] Label file mapped: " << std::setw(12) << map_time << " ms" << std::endl;
+    return 0;
+}
 
 int main(const int argc, char *argv[]) {
-    std::cout <<
-            "[INFO] Leider hab ich es, trotz der extra Zeit, nicht geschafft die CH preprocessing phase genuegend zu optimieren. "
-            << "Irgendwann hab ich gemerkt das ich wahrscheinlich komplett nochmal meine Wahl der Datenstruktur ueberdenken muesste, "
-            << "dafuer hatte ich aber leider keine Zeit mehr. .-. " << std::endl;
+    // customize a CCH with two metrics with '-cch [graph.fmi]'
+    if (argc > 1 && std::string(argv[1]) == "-cch") {
+        const auto graph_file_name = argc > 2 ? std::string(argv[2]) : default_graph_file_name;
+        return run_cch_benchmark(graph_file_name);
+    }
+
+    // compare the sequential query with the one searching both directions in parallel with '-parallel-query <graph.ch>'
+    if (argc > 2 && std::string(argv[1]) == "-parallel-query") {
+        const std::string ch_graph_file_name = argv[2];
+        std::fstream graph_file(ch_graph_file_name, std::ios::in);
+        if (!graph_file.is_open()) {
+            std::cout << "Couldn't open '" << ch_graph_file_name << "' file!" << std::endl;
+            return 1;
+        }
+        const auto graph = exercise::two::CHGraph(std::move(graph_file), true);
+        run_parallel_query_comparison(graph);
+        return 0;
+    }
+
+    // compare hub label queries with CH queries with '-hub-labels <graph.ch> [labels file]'
+    if (argc > 2 && std::string(argv[1]) == "-hub-labels") {
+        const std::string ch_graph_file_name = argv[2];
+        const auto labels_file_name = argc > 3 ? std::string(argv[3]) : ch_graph_file_name + hub_labels_file_extension;
+        std::fstream graph_file(ch_graph_file_name, std::ios::in);
+        if (!graph_file.is_open()) {
+            std::cout << "Couldn't open '" << ch_graph_file_name << "' file!" << std::endl;
+            return 1;
+        }
+        const auto graph = exercise::two::CHGraph(std::move(graph_file), true);
+        return run_hub_labels_benchmark(graph, labels_file_name);
+    }
+
+    // compare one-to-all distances of PHAST and Dijkstra with '-phast <graph.ch> [source count]'
+    if (argc > 2 && std::string(argv[1]) == "-phast") {
+        const std::string ch_graph_file_name = argv[2];
+        const auto source_count = argc > 3 ? std::max(1, std::stoi(argv[3])) : DEFAULT_PHAST_SOURCE_COUNT;
+        std::fstream graph_file(ch_graph_file_name, std::ios::in);
+        if (!graph_file.is_open()) {
+            std::cout << "Couldn't open '" << ch_graph_file_name << "' file!" << std::endl;
+            return 1;
+        }
+        const auto graph = exercise::two::CHGraph(std::move(graph_file), true);
+        run_phast_benchmark(graph, source_count);
+        return 0;
+    }
+
+    // compare a distance table with single queries with '-table <graph.ch> [size]'
+    if (argc > 2 && std::string(argv[1]) == "-table") {
+        const std::string ch_graph_file_name = argv[2];
+        const auto table_size = argc > 3 ? std::max(1, std::stoi(argv[3])) : DEFAULT_TABLE_SIZE;
+        std::fstream graph_file(ch_graph_file_name, std::ios::in);
+        if (!graph_file.is_open()) {
+            std::cout << "Couldn't open '" << ch_graph_file_name << "' file!" << std::endl;
+            return 1;
+        }
+        const auto graph = exercise::two::CHGraph(std::move(graph_file), true);
+        run_distance_table_benchmark(graph, table_size);
+        return 0;
+    }
+
+    // compare the search spaces with and without stall-on-demand with '-search-space <graph.ch> [queries.txt]'
+    if (argc > 2 && std::string(argv[1]) == "-search-space") {
+        const std::string ch_graph_file_name = argv[2];
+        const auto query_file_name = argc > 3 ? std::string(argv[3]) : default_query_file_name;
+        std::fstream graph_file(ch_graph_file_name, std::ios::in);
+        if (!graph_file.is_open()) {
+            std::cout << "Couldn't open '" << ch_graph_file_name << "' file!" << std::endl;
+            return 1;
+        }
+        const auto graph = exercise::two::CHGraph(std::move(graph_file), true);
+        return run_search_space_comparison(graph, query_file_name);
+    }
+
+    // compare the node orderings of the preprocessing with '-compare-ordering [graph.fmi]'
+    if (argc > 1 && std::string(argv[1]) == "-compare-ordering") {
+        const auto graph_file_name = argc > 2 ? std::string(argv[2]) : default_graph_file_name;
+        if (!fs::exists(graph_file_name)) {
+            std::cout << "Couldn't find '" << graph_file_name << "' file!" << std::endl;
+            return 1;
+        }
+        return run_ordering_comparison(graph_file_name);
+    }
 
     // try read-in CH graph from command line path provided by '-ch' option
+    // or a previously saved query data structure provided by '-snapshot' option
     std::string ch_graph_file_name;
+    std::string snapshot_file_name;
     if (argc > 2) {
         if (std::string(argv[1]) == "-ch") {
             ch_graph_file_name = argv[2];
+        } else if (std::string(argv[1]) == "-snapshot") {
+            snapshot_file_name = argv[2];
         }
     }
+    if (!snapshot_file_name.empty()) {
+        std::cout << "Loading graph from snapshot: '" << snapshot_file_name << "'" << std::endl;
+        auto sw = Stopwatch<std::chrono::microseconds>::Start();
+        const auto graph = exercise::two::CHGraph::from_snapshot(snapshot_file_name);
+        if (!graph) {
+            std::cout << "Couldn't load '" << snapshot_file_name << "' file!" << std::endl;
+            return 1;
+        }
+        std::cout << "Loaded in " << sw.Stop() / 1000 << "ms\n" << std::endl;
+
+        run_query_benchmark(*graph);
+        return 0;
+    }
     if (!ch_graph_file_name.empty()) {
         if (!fs::exists(ch_graph_file_name)) {
             std::cout << "Couldn't find '" << ch_graph_file_name << "' file!" << std::endl;
             return 1;
         }
-        std::fstream graph_file(ch_graph_file_name, std::ios::in);
-        if (!graph_file.is_open()) {
-            std::cout << "Couldn't open '" << ch_graph_file_name << "' file!" << std::endl;
-            return 1;
-        }
 
         // problem 1
         std::cout << "Creating graph from file: '" << ch_graph_file_name << "'" << std::endl;
         auto sw = Stopwatch<std::chrono::microseconds>::Start();
-        const auto graph = exercise::two::CHGraph(std::move(graph_file), true);
+        const auto graph = exercise::two::CHGraph::from_ch_file(ch_graph_file_name);
+        if (!graph) {
+            std::cout << "Couldn't read '" << ch_graph_file_name << "' file!" << std::endl;
+            return 1;
+        }
         std::cout << "Created in " << sw.Stop() / 1000 << "ms\n" << std::endl;
+        save_snapshot(*graph, ch_graph_file_name);
 
-        std::cout << "Calculating " << CH_ITERATIONS << " shortest path queries:" << std::endl;
-        long long overall_time = 0;
-        for (int i = 0; i < CH_ITERATIONS; ++i) {
-            const int start = std::rand() % graph.get_node_count();
-            const int end = std::rand() % graph.get_node_count();
-
-            sw.Restart();
-            const auto dist = graph.compute_shortest_path(start, end);
-            overall_time += sw.Split();
-        }
-        std::cout << "Computed in average of " << overall_time / CH_ITERATIONS << "us\n" << std::endl;
+        run_query_benchmark(*graph);
         return 0;
     }
 
@@ -78,6 +653,8 @@ int main(const int argc, char *argv[]) {
     auto sw = Stopwatch<std::chrono::seconds>::Start();
     const auto graph = exercise::two::CHGraph(std::move(graph_file), false);
     std::cout << "Created in " << sw.Stop() << "s\n" << std::endl;
+    save_snapshot(graph, graph_file_name);
+    save_ch_file(graph, graph_file_name);
 
     {
         constexpr int start = 377371, end = 754742, result = 436627;
@@ -0,0 +1,160 @@
+//
+// Created by Jost on 17/10/2026.
+//
+
+#include "packed_ch_edges.h"
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <tuple>
+
+#include "csr_builder.h"
+
+namespace exercise::two {
+    // bits needed to store the value
+    static int bit_width(const uint32_t value) {
+        int bits = 0;
+        while (bits < 32 && value >> bits != 0) {
+            bits++;
+        }
+        return bits;
+    }
+
+    static uint32_t zigzag(const int value) {
+        return static_cast<uint32_t>(value) << 1 ^ static_cast<uint32_t>(value >> 31);
+    }
+
+    // up only edges first and down only edges last
+    static int direction_order(const uint32_t directions) {
+        return directions == PackedCHEdges::UP ? 0 : directions == PackedCHEdges::DOWN ? 2 : 1;
+    }
+
+    void PackedCHEdges::build(const int node_count, const std::vector<BuildEdge> &edges, const int thread_count) {
+        std::vector<int> edge_offsets;
+        std::vector<BuildEdge> node_edges;
+        build_csr(edges, node_count, edge_offsets, node_edges,
+                  [](const BuildEdge &edge) { return edge.node; },
+                  [](const BuildEdge &edge) { return edge; },
+                  thread_count);
+
+        // sorting by neighbour puts both directions of an edge next to each other, the merged edges stay at the
+        // front of the range of their node and are then ordered by their directions
+        std::vector<int> merged_counts(node_count);
+        parallel_for_chunks(node_count, thread_count, [&](const size_t first_node, const size_t last_node) {
+            for (auto node = first_node; node < last_node; ++node) {
+                const auto first = node_edges.begin() + edge_offsets[node];
+                const auto last = node_edges.begin() + edge_offsets[node + 1];
+                std::sort(first, last, [](const BuildEdge &a, const BuildEdge &b) {
+                    return std::tie(a.neighbour, a.weight, a.middle) < std::tie(b.neighbour, b.weight, b.middle);
+                });
+
+                auto merged = first;
+                for (auto it = first; it != last; ++it) {
+                    if (merged != first && std::prev(merged)->neighbour == it->neighbour
+                        && std::prev(merged)->weight == it->weight && std::prev(merged)->middle == it->middle) {
+                        std::prev(merged)->directions |= it->directions;
+                    } else {
+                        *merged++ = *it;
+                    }
+                }
+                std::stable_sort(first, merged, [](const BuildEdge &a, const BuildEdge &b) {
+                    return direction_order(a.directions) < direction_order(b.directions);
+                });
+                merged_counts[node] = static_cast<int>(merged - first);
+            }
+        });
+
+        // histogram over the bits of weight and difference, every split of the payload is checked against it
+        std::array<std::array<long long, 33>, 33> bit_counts{};
+        for (int node = 0; node < node_count; ++node) {
+            for (int i = edge_offsets[node]; i < edge_offsets[node] + merged_counts[node]; ++i) {
+                const auto &edge = node_edges[i];
+                // negative weights don't fit into any split
+                const auto weight_bits = edge.weight < 0 ? 32 : bit_width(edge.weight);
+                bit_counts[weight_bits][bit_width(zigzag(edge.neighbour - node))]++;
+            }
+        }
+        long long fewest_escaped = -1;
+        for (int weight_bits = 0; weight_bits <= PAYLOAD_BITS; ++weight_bits) {
+            long long escaped = 0;
+            for (int i = 0; i <= 32; ++i) {
+                for (int j = 0; j <= 32; ++j) {
+                    if (i > weight_bits || j > PAYLOAD_BITS - weight_bits) {
+                        escaped += bit_counts[i][j];
+                    }
+                }
+            }
+            if (fewest_escaped == -1 || escaped < fewest_escaped) {
+                fewest_escaped = escaped;
+                m_weight_bits = weight_bits;
+            }
+        }
+        m_weight_mask = (1u << m_weight_bits) - 1;
+
+        m_offsets.resize(node_count + 1);
+        m_offsets[0] = 0;
+        for (int node = 0; node < node_count; ++node) {
+            m_offsets[node + 1] = m_offsets[node] + merged_counts[node];
+        }
+        m_entries.resize(m_offsets[node_count]);
+        m_middle_nodes.resize(m_offsets[node_count]);
+        m_escaped_edges.clear();
+        for (int node = 0; node < node_count; ++node) {
+            for (int i = 0; i < merged_counts[node]; ++i) {
+                const auto &edge = node_edges[edge_offsets[node] + i];
+                const auto position = m_offsets[node] + i;
+                const auto difference = zigzag(edge.neighbour - node);
+                m_middle_nodes[position] = edge.middle;
+
+                if (edge.weight >= 0 && bit_width(edge.weight) <= m_weight_bits
+                    && bit_width(difference) <= PAYLOAD_BITS - m_weight_bits) {
+                    const auto payload = difference << m_weight_bits | static_cast<uint32_t>(edge.weight);
+                    m_entries[position] = payload << PAYLOAD_SHIFT | edge.directions;
+                } else {
+                    const auto payload = static_cast<uint32_t>(m_escaped_edges.size());
+                    m_escaped_edges.push_back(Edge{edge.neighbour, edge.weight});
+                    m_entries[position] = payload << PAYLOAD_SHIFT | ESCAPED | edge.directions;
+                }
+            }
+        }
+    }
+
+    void PackedCHEdges::save(SnapshotWriter &writer) const {
+        writer.write_array(m_offsets);
+        writer.write_array(m_entries);
+        writer.write_array(m_escaped_edges);
+        writer.write_array(m_middle_nodes);
+        writer.write_array(std::vector<int>{m_weight_bits});
+    }
+
+    bool PackedCHEdges::load(SnapshotReader &reader) {
+        std::vector<int> weight_bits;
+        if (!reader.read_array(m_offsets) || !reader.read_array(m_entries) || !reader.read_array(m_escaped_edges)
+            || !reader.read_array(m_middle_nodes) || !reader.read_array(weight_bits)) {
+            return false;
+        }
+        if (m_offsets.empty() || m_offsets.back() != static_cast<int>(m_entries.size())
+            || m_middle_nodes.size() != m_entries.size() || weight_bits.size() != 1
+            || weight_bits[0] < 0 || weight_bits[0] > PAYLOAD_BITS) {
+            return false;
+        }
+
+        m_weight_bits = weight_bits[0];
+        m_weight_mask = (1u << m_weight_bits) - 1;
+        return true;
+    }
+
+    int PackedCHEdges::get_edge_count() const {
+        int count = 0;
+        for (const auto entry: m_entries) {
+            count += (entry & UP ? 1 : 0) + (entry & DOWN ? 1 : 0);
+        }
+        return count;
+    }
+
+    size_t PackedCHEdges::get_memory_size() const {
+        return m_offsets.size() * sizeof(int) + m_entries.size() * sizeof(uint32_t)
+               + m_escaped_edges.size() * sizeof(Edge) + m_middle_nodes.size() * sizeof(int);
+    }
+} // exercise::two
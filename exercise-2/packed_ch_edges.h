@@ -0,0 +1,143 @@
+//
+// Created by Jost on 17/10/2026.
+//
+
+#ifndef PACKED_CH_EDGES_H
+#define PACKED_CH_EDGES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "snapshot.h"
+
+namespace exercise::two {
+    struct Edge {
+        int to;
+        int weight;
+    };
+
+    /// Up and down edges of a contraction hierarchy in one array, every node stores its edges to nodes of the same
+    /// or a higher level. An entry is 32 bits:
+    ///   bit 0      UP, the edge node -> neighbour exists
+    ///   bit 1      DOWN, the edge neighbour -> node exists
+    ///   bit 2      ESCAPED, the payload is an index into the escaped edges
+    ///   bits 3-31  payload, the weight in the lower weight bits and above it the zigzag encoded difference
+    ///              neighbour index - node index
+    /// The split between weight and difference bits is chosen per graph so that the fewest edges need escaping.
+    /// Both directions of a road share one entry if they have the same weight and shortcut middle node. The entries
+    /// of a node start with the up only ones and end with the down only ones, so a search in one direction stops at
+    /// the first entry without it instead of testing every entry.
+    class PackedCHEdges {
+    public:
+        static constexpr uint32_t UP = 1;
+        static constexpr uint32_t DOWN = 2;
+
+        struct BuildEdge {
+            int node;
+            int neighbour;
+            int weight;
+            int middle;
+            uint32_t directions;
+        };
+
+        /// Groups the edges by node and packs them, edges that only differ in their directions are merged
+        void build(int node_count, const std::vector<BuildEdge> &edges, int thread_count);
+
+        void save(SnapshotWriter &writer) const;
+
+        /// Returns false if the arrays in the snapshot don't fit together
+        bool load(SnapshotReader &reader);
+
+        [[nodiscard]] int get_node_count() const {
+            return static_cast<int>(m_offsets.size()) - 1;
+        }
+
+        /// Entries of the node are at positions [begin(node), end(node))
+        [[nodiscard]] int begin(const int node) const {
+            return m_offsets[node];
+        }
+
+        [[nodiscard]] int end(const int node) const {
+            return m_offsets[node + 1];
+        }
+
+        [[nodiscard]] uint32_t get_directions(const int position) const {
+            return m_entries[position] & (UP | DOWN);
+        }
+
+        /// Calls visit(position, edge) for every entry of the node with the direction
+        template<typename Visit>
+        void for_each_edge(const int node, const uint32_t direction, const Visit &visit) const {
+            const auto first = begin(node);
+            const auto last = end(node);
+            if (direction == UP) {
+                for (int i = first; i < last && (m_entries[i] & UP); ++i) {
+                    visit(i, get_edge(node, i));
+                }
+            } else {
+                for (int i = last - 1; i >= first && (m_entries[i] & DOWN); --i) {
+                    visit(i, get_edge(node, i));
+                }
+            }
+        }
+
+        /// True if the predicate holds for the edge of any entry of the node with the direction
+        template<typename Predicate>
+        [[nodiscard]] bool any_edge(const int node, const uint32_t direction, const Predicate &predicate) const {
+            const auto first = begin(node);
+            const auto last = end(node);
+            if (direction == UP) {
+                for (int i = first; i < last && (m_entries[i] & UP); ++i) {
+                    if (predicate(get_edge(node, i)))
+                        return true;
+                }
+            } else {
+                for (int i = last - 1; i >= first && (m_entries[i] & DOWN); --i) {
+                    if (predicate(get_edge(node, i)))
+                        return true;
+                }
+            }
+            return false;
+        }
+
+        /// The neighbour and weight of the entry at the position, which has to be one of the entries of the node
+        [[nodiscard]] Edge get_edge(const int node, const int position) const {
+            const auto entry = m_entries[position];
+            const auto payload = entry >> PAYLOAD_SHIFT;
+            if (entry & ESCAPED)
+                return m_escaped_edges[payload];
+
+            const auto zigzag_difference = payload >> m_weight_bits;
+            const auto difference = static_cast<int>(zigzag_difference >> 1)
+                                    ^ -static_cast<int>(zigzag_difference & 1);
+            return Edge{node + difference, static_cast<int>(payload & m_weight_mask)};
+        }
+
+        /// Node skipped by the shortcut at the position, -1 for original edges
+        [[nodiscard]] int get_middle_node(const int position) const {
+            return m_middle_nodes[position];
+        }
+
+        /// Up and down edges counted separately, as if they were stored in two graphs
+        [[nodiscard]] int get_edge_count() const;
+
+        /// Bytes of all edge arrays including the middle nodes, which only the path unpacking reads
+        [[nodiscard]] size_t get_memory_size() const;
+
+    private:
+        static constexpr uint32_t ESCAPED = 4;
+        static constexpr int PAYLOAD_SHIFT = 3;
+        static constexpr int PAYLOAD_BITS = 32 - PAYLOAD_SHIFT;
+
+        std::vector<int> m_offsets;
+        std::vector<uint32_t> m_entries;
+        std::vector<Edge> m_escaped_edges;
+        std::vector<int> m_middle_nodes;
+        int m_weight_bits = 0;
+        uint32_t m_weight_mask = 0;
+    };
+
+} // exercise::two
+
+#endif //PACKED_CH_EDGES_H
@@ -2,10 +2,16 @@
 // Created by Jost on 08/05/2025.
 //
 
+#include <algorithm>
 #include <charconv>
+#include <cstring>
 #include <string>
+#include <string_view>
 #include "parse_ch_graph_file.h"
 
+#include "csr_builder.h"
+#include "mapped_file.h"
+
 namespace exercise::two {
     enum READ_STATE {
         META,
@@ -27,6 +33,7 @@ namespace exercise::two {
         return CHNode{id, level};
     }
 
+    /// The middle of the returned edge is the index of its first child edge, -1 for an original edge
     static CHEdge parse_edge(const std::string_view line) {
         const auto from_end = line.find(' ');
         const auto to_start = from_end + 1;
@@ -39,7 +46,17 @@ namespace exercise::two {
         std::from_chars(line.data() + to_start, line.data() + to_end, to);
         std::from_chars(line.data() + weight_start, line.data() + weight_end, weight);
 
-        return CHEdge{from, to, weight};
+        // type and max speed are skipped
+        int child = -1;
+        const auto type_end = weight_end == std::string_view::npos ? weight_end : line.find(' ', weight_end + 1);
+        const auto max_speed_end = type_end == std::string_view::npos ? type_end : line.find(' ', type_end + 1);
+        if (max_speed_end != std::string_view::npos) {
+            const auto child_start = max_speed_end + 1;
+            const auto child_end = std::min(line.find(' ', child_start), line.length());
+            std::from_chars(line.data() + child_start, line.data() + child_end, child);
+        }
+
+        return CHEdge{from, to, weight, child};
     }
 
     int parse_ch_file(std::fstream input_file, std::vector<CHNode> &nodes, std::vector<CHEdge> &edges) {
@@ -87,6 +104,109 @@ namespace exercise::two {
         }
         input_file.close();
 
+        // the first child of a shortcut ends in the skipped node
+        for (auto &edge: edges) {
+            if (edge.middle >= 0 && edge.middle < edges.size()) {
+                edge.middle = edges[edge.middle].to;
+            } else {
+                edge.middle = -1;
+            }
+        }
+
         return static_cast<int>(nodes.size());
     }
+
+    /// Line starting at position and the position behind its line break
+    static std::string_view next_line(const char *data, const size_t size, size_t &position) {
+        const auto *line_end = static_cast<const char *>(std::memchr(data + position, '\n', size - position));
+        const auto end = line_end == nullptr ? size : static_cast<size_t>(line_end - data);
+        const std::string_view line(data + position, end - position);
+        position = std::min(size, end + 1);
+        return line;
+    }
+
+    int parse_ch_file(const std::string &file_name, std::vector<CHNode> &nodes, std::vector<CHEdge> &edges,
+                      int thread_count) {
+        const MappedFile file(file_name);
+        if (!file.is_open())
+            return -1;
+
+        const auto *data = file.data();
+        const auto size = file.size();
+        thread_count = std::max(1, thread_count);
+
+        // metadata section ends with an empty line, the counts follow
+        size_t position = 0;
+        while (position < size) {
+            if (next_line(data, size, position).empty())
+                break;
+        }
+        const auto node_count_line = next_line(data, size, position);
+        const auto edge_count_line = next_line(data, size, position);
+        int node_count = 0;
+        int edge_count = 0;
+        if (std::from_chars(node_count_line.data(), node_count_line.data() + node_count_line.size(), node_count).ec
+            != std::errc() || std::from_chars(edge_count_line.data(), edge_count_line.data() + edge_count_line.size(),
+                                              edge_count).ec != std::errc())
+            return -1;
+        nodes.resize(node_count);
+        edges.resize(edge_count);
+        const auto line_count = static_cast<long long>(node_count) + edge_count;
+
+        // the remaining bytes are split into one chunk per thread, every chunk starts behind a line break
+        const auto body_begin = position;
+        std::vector<size_t> chunk_begins(thread_count + 1, size);
+        chunk_begins[0] = body_begin;
+        for (int chunk = 1; chunk < thread_count; ++chunk) {
+            auto begin = std::max(chunk_begins[chunk - 1], body_begin + (size - body_begin) * chunk / thread_count);
+            if (begin > body_begin && begin < size && data[begin - 1] != '\n') {
+                const auto *line_break = static_cast<const char *>(std::memchr(data + begin, '\n', size - begin));
+                begin = line_break == nullptr ? size : static_cast<size_t>(line_break - data) + 1;
+            }
+            chunk_begins[chunk] = begin;
+        }
+
+        // the line numbers of the chunks are only known once all lines in front of them are counted
+        std::vector<long long> chunk_lines(thread_count + 1, 0);
+        parallel_for_chunks(thread_count, thread_count, [&](const size_t chunk, size_t) {
+            chunk_lines[chunk + 1] = std::count(data + chunk_begins[chunk], data + chunk_begins[chunk + 1], '\n');
+            // a last line without a line break
+            if (chunk_begins[chunk + 1] == size && size > chunk_begins[chunk] && data[size - 1] != '\n') {
+                chunk_lines[chunk + 1]++;
+            }
+        });
+        for (int chunk = 0; chunk < thread_count; ++chunk) {
+            chunk_lines[chunk + 1] += chunk_lines[chunk];
+        }
+        if (chunk_lines[thread_count] < line_count)
+            return -1;
+
+        // lines behind the announced nodes and edges are ignored like in the sequential parser
+        parallel_for_chunks(thread_count, thread_count, [&](const size_t chunk, size_t) {
+            auto line_position = chunk_begins[chunk];
+            for (auto line_index = chunk_lines[chunk];
+                 line_position < chunk_begins[chunk + 1] && line_index < line_count; ++line_index) {
+                const auto line = next_line(data, size, line_position);
+                if (line_index < node_count) {
+                    nodes[line_index] = parse_ch_node(line);
+                } else {
+                    edges[line_index - node_count] = parse_edge(line);
+                }
+            }
+        });
+
+        // the first child of a shortcut ends in the skipped node, only the middle of each edge is written
+        parallel_for_chunks(edges.size(), thread_count, [&edges](const size_t begin, const size_t end) {
+            for (auto i = begin; i < end; ++i) {
+                auto &edge = edges[i];
+                if (edge.middle >= 0 && edge.middle < edges.size()) {
+                    edge.middle = edges[edge.middle].to;
+                } else {
+                    edge.middle = -1;
+                }
+            }
+        });
+
+        return node_count;
+    }
 }
@@ -6,6 +6,8 @@
 #define PARSE_CH_GRAPH_FILE_H
 
 #include <fstream>
+#include <string>
+#include <thread>
 #include <vector>
 
 namespace exercise::two {
@@ -17,9 +19,16 @@ namespace exercise::two {
     struct CHEdge {
         int from, to;
         int weight;
+        /// node a shortcut skips, -1 for an original edge
+        int middle = -1;
     };
 
     int parse_ch_file(std::fstream input_file, std::vector<CHNode> &nodes, std::vector<CHEdge> &edges);
+
+    /// Same format, but the file is mapped and split into chunks of whole lines that are parsed in parallel.
+    /// Returns -1 if the file can't be mapped or has fewer lines than its counts announce
+    int parse_ch_file(const std::string &file_name, std::vector<CHNode> &nodes, std::vector<CHEdge> &edges,
+                      int thread_count = static_cast<int>(std::thread::hardware_concurrency()));
 }
 
 #endif //PARSE_CH_GRAPH_FILE_H
@@ -16,15 +16,6 @@ namespace exercise::two {
         FINISHED
     };
 
-    static CHBuildNode parse_fmi_node(const std::string_view line) {
-        const auto id_end = line.find_first_of(' ');
-
-        int id;
-        std::from_chars(line.data(), line.data() + id_end, id);
-
-        return CHBuildNode{id, -1};
-    }
-
     static FMIEdge parse_edge(const std::string_view line) {
         const auto from_end = line.find(' ');
         const auto to_start = from_end + 1;
@@ -40,9 +31,9 @@ namespace exercise::two {
         return FMIEdge{from, to, weight};
     }
 
-    int parse_fmi_file(std::fstream input_file, std::vector<CHBuildNode> &nodes) {
+    int parse_fmi_file(std::fstream input_file, std::vector<FMIEdge> &edges) {
         auto state = READ_STATE::META;
-        int edge_count = 0;
+        int node_count = 0;
 
         int node_index = 0;
         int edge_index = 0;
@@ -58,35 +49,31 @@ namespace exercise::two {
                 }
 
                 case READ_STATE::NODE_COUNT: {
-                    nodes.resize(std::stoi(line));
+                    node_count = std::stoi(line);
                     state = READ_STATE::EDGE_COUNT;
                     break;
                 }
 
                 case READ_STATE::EDGE_COUNT: {
-                    edge_count = std::stoi(line);
+                    edges.resize(std::stoi(line));
                     state = READ_STATE::NODES;
                     break;
                 }
 
                 case READ_STATE::NODES: {
-                    const auto node = parse_fmi_node(line);
-                    nodes[node.id] = node;
-
+                    // only the edges are needed for the contraction, nodes are identified by their index
                     node_index++;
 
-                    if (node_index >= nodes.size()) {
+                    if (node_index >= node_count) {
                         state = READ_STATE::EDGES;
                     }
                     break;
                 }
 
                 case READ_STATE::EDGES: {
-                    auto [from, to, weight] = parse_edge(line);
-                    nodes[from].out_edges.emplace_back(to, weight);
-                    nodes[to].in_edges.emplace_back(from, weight);
+                    edges[edge_index] = parse_edge(line);
                     edge_index++;
-                    if (edge_index >= edge_count) {
+                    if (edge_index >= edges.size()) {
                         state = READ_STATE::FINISHED;
                     }
                     break;
@@ -99,6 +86,6 @@ namespace exercise::two {
         }
         input_file.close();
 
-        return edge_count;
+        return node_count;
     }
 }
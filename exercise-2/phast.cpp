@@ -0,0 +1,107 @@
+//
+// Created by Jost on 17/10/2026.
+//
+
+#include "phast.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "priority_queues.h"
+
+namespace exercise::two {
+    // half the range, so adding a weight to an unreached node can't overflow in the sweep
+    constexpr int UNREACHED = std::numeric_limits<int>::max() / 2;
+
+    PHAST::PHAST(const CHGraph &graph) : m_graph(&graph) {
+    }
+
+    std::vector<int> PHAST::compute_distances(const int source) const {
+        return compute_distances<1>(std::vector<int>{source});
+    }
+
+    template<int LANES>
+    std::vector<int> PHAST::compute_distances(const std::vector<int> &sources) const {
+        const auto node_count = m_graph->get_node_count();
+        std::vector<int> distances(sources.size() * node_count);
+        std::vector<int> lane_distances(static_cast<size_t>(node_count) * LANES);
+
+        for (size_t first = 0; first < sources.size(); first += LANES) {
+            const auto source_count = static_cast<int>(std::min<size_t>(LANES, sources.size() - first));
+            sweep<LANES>(sources.data() + first, source_count, lane_distances);
+
+            // back from level order and interleaved lanes to one row per source
+            for (int lane = 0; lane < source_count; ++lane) {
+                auto row = distances.begin() + static_cast<long long>(first + lane) * node_count;
+                for (int index = 0; index < node_count; ++index) {
+                    const auto distance = lane_distances[static_cast<size_t>(index) * LANES + lane];
+                    row[m_graph->get_node_id(index)] = distance >= UNREACHED ? -1 : distance;
+                }
+            }
+        }
+        return distances;
+    }
+
+    template<int LANES>
+    void PHAST::sweep(const int *sources, const int source_count, std::vector<int> &lane_distances) const {
+        const auto node_count = m_graph->get_node_count();
+        std::fill(lane_distances.begin(), lane_distances.end(), UNREACHED);
+
+        const auto &edges = m_graph->get_edges();
+
+        // upward search of every source into its own lane
+        BinaryHeap queue;
+        for (int lane = 0; lane < source_count; ++lane) {
+            if (sources[lane] < 0 || sources[lane] >= node_count)
+                continue;
+
+            const auto distance_of = [&lane_distances, lane](const int index) -> int & {
+                return lane_distances[static_cast<size_t>(index) * LANES + lane];
+            };
+
+            const auto source = m_graph->get_node_index(sources[lane]);
+            queue.reset(node_count);
+            distance_of(source) = 0;
+            queue.push(source, 0);
+            while (!queue.empty()) {
+                const auto [index, distance] = queue.pop();
+
+                // old invalid entry, not removed for performance
+                if (distance > distance_of(index)) {
+                    continue;
+                }
+
+                edges.for_each_edge(index, PackedCHEdges::UP, [&](int, const Edge edge) {
+                    const auto [neighbour_index, weight] = edge;
+                    if (const auto new_distance = distance + weight; new_distance < distance_of(neighbour_index)) {
+                        distance_of(neighbour_index) = new_distance;
+                        queue.push(neighbour_index, new_distance);
+                    }
+                });
+            }
+        }
+
+        // every down edge comes from a node of a higher level, which is final once the sweep reaches this node.
+        // Edges between nodes of the same level only exist in the uncontracted top level, which the upward
+        // search already covered completely
+        for (int index = 0; index < node_count; ++index) {
+            int *distances = lane_distances.data() + static_cast<size_t>(index) * LANES;
+
+            // the lanes are kept in a local copy, so the compiler knows they don't alias the higher node
+            int lanes[LANES];
+            std::copy_n(distances, LANES, lanes);
+            edges.for_each_edge(index, PackedCHEdges::DOWN, [&](int, const Edge edge) {
+                const int *higher_distances = lane_distances.data() + static_cast<size_t>(edge.to) * LANES;
+                for (int lane = 0; lane < LANES; ++lane) {
+                    lanes[lane] = std::min(lanes[lane], higher_distances[lane] + edge.weight);
+                }
+            });
+            std::copy_n(lanes, LANES, distances);
+        }
+    }
+
+    template std::vector<int> PHAST::compute_distances<1>(const std::vector<int> &) const;
+    template std::vector<int> PHAST::compute_distances<4>(const std::vector<int> &) const;
+    template std::vector<int> PHAST::compute_distances<8>(const std::vector<int> &) const;
+    template std::vector<int> PHAST::compute_distances<16>(const std::vector<int> &) const;
+} // exercise::two
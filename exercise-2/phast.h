@@ -0,0 +1,37 @@
+//
+// Created by Jost on 17/10/2026.
+//
+
+#ifndef PHAST_H
+#define PHAST_H
+
+#include <vector>
+
+#include "ch_graph.h"
+
+namespace exercise::two {
+    /// One-to-all distances on a contraction hierarchy: an upward search from the source followed by a single sweep
+    /// over all nodes in descending level order, that relaxes the down edges into every node. The sweep reads the
+    /// CH arrays front to back, so it runs in O(nodes + edges) without a priority queue.
+    class PHAST {
+    public:
+        explicit PHAST(const CHGraph &graph);
+
+        /// Distances from source to all nodes indexed by node id, -1 if a node can't be reached
+        [[nodiscard]] std::vector<int> compute_distances(int source) const;
+
+        /// Distances from every source to all nodes, the distance from sources[i] to node v is at
+        /// i * node count + v. Each sweep handles LANES sources at once, the lanes of a node are stored next to
+        /// each other, so relaxing an edge is a vectorized add and min. Instantiated for 1, 4, 8 and 16 lanes
+        template<int LANES>
+        [[nodiscard]] std::vector<int> compute_distances(const std::vector<int> &sources) const;
+
+    private:
+        const CHGraph *m_graph;
+
+        template<int LANES>
+        void sweep(const int *sources, int source_count, std::vector<int> &lane_distances) const;
+    };
+} // exercise::two
+
+#endif //PHAST_H
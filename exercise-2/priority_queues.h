@@ -0,0 +1,276 @@
+//
+// Created by Jost on 17/10/2026.
+//
+
+#ifndef PRIORITY_QUEUES_H
+#define PRIORITY_QUEUES_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace exercise::two {
+    struct SPNode {
+        int index;
+        int distance;
+
+        // inverted, so the std heap functions build a min heap ordered by distance
+        constexpr bool operator<(const SPNode &other) const {
+            return distance > other.distance;
+        }
+    };
+
+    struct QueueStatistics {
+        long long pushes = 0;
+        long long pops = 0;
+        long long decrease_keys = 0;
+    };
+
+    // All queues share the same interface, so the Dijkstra implementations can be templated on them:
+    //   reset(index_count)  empties the queue for a new search over indices in [0, index_count)
+    //   push(index, key)    inserts the index or lowers its key
+    //   pop()               removes the entry with the smallest key, lazy queues may return outdated entries
+    //                       that the caller has to skip by comparing with its own distance
+    //   empty()
+
+    /// Binary heap with lazy deletion: every decrease key pushes a duplicate entry
+    class BinaryHeap {
+    public:
+        void reset(int) {
+            m_heap.clear();
+        }
+
+        [[nodiscard]] bool empty() const {
+            return m_heap.empty();
+        }
+
+        void push(const int index, const int key) {
+            m_statistics.pushes++;
+            m_heap.push_back(SPNode{index, key});
+            std::push_heap(m_heap.begin(), m_heap.end());
+        }
+
+        SPNode pop() {
+            m_statistics.pops++;
+            std::pop_heap(m_heap.begin(), m_heap.end());
+            const auto top = m_heap.back();
+            m_heap.pop_back();
+            return top;
+        }
+
+        [[nodiscard]] const QueueStatistics &statistics() const {
+            return m_statistics;
+        }
+
+        void reset_statistics() {
+            m_statistics = QueueStatistics{};
+        }
+
+    private:
+        std::vector<SPNode> m_heap;
+        QueueStatistics m_statistics;
+    };
+
+    /// Addressable 4-ary heap, every index is stored at most once and decrease key moves it up in place
+    class QuaternaryHeap {
+    public:
+        void reset(const int index_count) {
+            for (const auto &entry: m_heap) {
+                m_positions[entry.index] = NOT_IN_HEAP;
+            }
+            m_heap.clear();
+
+            if (index_count > static_cast<int>(m_positions.size())) {
+                m_positions.resize(index_count, NOT_IN_HEAP);
+            }
+        }
+
+        [[nodiscard]] bool empty() const {
+            return m_heap.empty();
+        }
+
+        void push(const int index, const int key) {
+            auto position = m_positions[index];
+            if (position == NOT_IN_HEAP) {
+                m_statistics.pushes++;
+                position = static_cast<int>(m_heap.size());
+                m_heap.push_back(SPNode{index, key});
+            } else {
+                if (key >= m_heap[position].distance)
+                    return;
+                m_statistics.decrease_keys++;
+                m_heap[position].distance = key;
+            }
+            sift_up(position);
+        }
+
+        /// Sets the key of the index to any value, inserts it if it isn't in the heap
+        void update(const int index, const int key) {
+            const auto position = m_positions[index];
+            if (position == NOT_IN_HEAP || key < m_heap[position].distance) {
+                push(index, key);
+                return;
+            }
+            m_heap[position].distance = key;
+            sift_down(position);
+        }
+
+        /// Entry with the smallest key, the heap must not be empty
+        [[nodiscard]] const SPNode &top() const {
+            return m_heap.front();
+        }
+
+        SPNode pop() {
+            m_statistics.pops++;
+            const auto top = m_heap.front();
+            m_positions[top.index] = NOT_IN_HEAP;
+
+            const auto last = m_heap.back();
+            m_heap.pop_back();
+            if (!m_heap.empty()) {
+                m_heap.front() = last;
+                sift_down(0);
+            }
+            return top;
+        }
+
+        [[nodiscard]] const QueueStatistics &statistics() const {
+            return m_statistics;
+        }
+
+        void reset_statistics() {
+            m_statistics = QueueStatistics{};
+        }
+
+    private:
+        static constexpr int NOT_IN_HEAP = -1;
+        static constexpr int ARITY = 4;
+
+        std::vector<SPNode> m_heap;
+        std::vector<int> m_positions;
+        QueueStatistics m_statistics;
+
+        void sift_up(int position) {
+            const auto entry = m_heap[position];
+            while (position > 0) {
+                const auto parent = (position - 1) / ARITY;
+                if (m_heap[parent].distance <= entry.distance)
+                    break;
+
+                m_heap[position] = m_heap[parent];
+                m_positions[m_heap[position].index] = position;
+                position = parent;
+            }
+            m_heap[position] = entry;
+            m_positions[entry.index] = position;
+        }
+
+        void sift_down(int position) {
+            const auto entry = m_heap[position];
+            const auto size = static_cast<int>(m_heap.size());
+            while (true) {
+                const auto first_child = position * ARITY + 1;
+                if (first_child >= size)
+                    break;
+
+                auto min_child = first_child;
+                const auto last_child = std::min(first_child + ARITY, size);
+                for (int child = first_child + 1; child < last_child; ++child) {
+                    if (m_heap[child].distance < m_heap[min_child].distance) {
+                        min_child = child;
+                    }
+                }
+                if (m_heap[min_child].distance >= entry.distance)
+                    break;
+
+                m_heap[position] = m_heap[min_child];
+                m_positions[m_heap[position].index] = position;
+                position = min_child;
+            }
+            m_heap[position] = entry;
+            m_positions[entry.index] = position;
+        }
+    };
+
+    /// Radix heap for non-negative integer keys, it relies on the popped keys never decreasing (true for Dijkstra).
+    /// Keys are bucketed by the highest bit in which they differ from the last popped key, so every entry moves
+    /// at most 32 times. Decrease key pushes a duplicate like the binary heap.
+    class RadixHeap {
+    public:
+        void reset(int) {
+            for (auto &bucket: m_buckets) {
+                bucket.clear();
+            }
+            m_last_key = 0;
+            m_size = 0;
+        }
+
+        [[nodiscard]] bool empty() const {
+            return m_size == 0;
+        }
+
+        void push(const int index, const int key) {
+            m_statistics.pushes++;
+            m_buckets[bucket_index(static_cast<uint32_t>(key))].push_back(SPNode{index, key});
+            m_size++;
+        }
+
+        SPNode pop() {
+            m_statistics.pops++;
+            if (m_buckets[0].empty()) {
+                // refill bucket 0 by redistributing the first non-empty bucket around its minimum
+                int i = 1;
+                while (m_buckets[i].empty()) {
+                    i++;
+                }
+
+                auto &bucket = m_buckets[i];
+                const auto min_entry = std::min_element(bucket.begin(), bucket.end(),
+                                                        [](const SPNode &a, const SPNode &b) {
+                                                            return a.distance < b.distance;
+                                                        });
+                m_last_key = static_cast<uint32_t>(min_entry->distance);
+                for (const auto &entry: bucket) {
+                    m_buckets[bucket_index(static_cast<uint32_t>(entry.distance))].push_back(entry);
+                }
+                bucket.clear();
+            }
+
+            const auto top = m_buckets[0].back();
+            m_buckets[0].pop_back();
+            m_size--;
+            return top;
+        }
+
+        [[nodiscard]] const QueueStatistics &statistics() const {
+            return m_statistics;
+        }
+
+        void reset_statistics() {
+            m_statistics = QueueStatistics{};
+        }
+
+    private:
+        std::array<std::vector<SPNode>, 33> m_buckets;
+        uint32_t m_last_key = 0;
+        size_t m_size = 0;
+        QueueStatistics m_statistics;
+
+        /// 0 for keys equal to the last popped key, otherwise 1 + index of the highest differing bit
+        [[nodiscard]] int bucket_index(const uint32_t key) const {
+            const auto difference = key ^ m_last_key;
+#if defined(__GNUC__) || defined(__clang__)
+            return difference == 0 ? 0 : 32 - __builtin_clz(difference);
+#else
+            int index = 0;
+            for (auto bits = difference; bits != 0; bits >>= 1) {
+                index++;
+            }
+            return index;
+#endif
+        }
+    };
+} // exercise::two
+
+#endif //PRIORITY_QUEUES_H
@@ -0,0 +1,117 @@
+//
+// Created by Jost on 17/10/2026.
+//
+
+#ifndef QUERY_WORKSPACE_H
+#define QUERY_WORKSPACE_H
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "priority_queues.h"
+
+namespace exercise::two {
+    /// Distance array that is reset in O(1): every entry remembers the query it was written in,
+    /// entries of older queries read as infinity.
+    class TimestampedDistances {
+    public:
+        static constexpr int INFINITE_DISTANCE = std::numeric_limits<int>::max();
+
+        explicit TimestampedDistances(const int size = 0) {
+            resize(size);
+        }
+
+        void resize(const int size) {
+            if (size > static_cast<int>(m_entries.size())) {
+                m_entries.resize(size, Entry{INFINITE_DISTANCE, 0});
+            }
+        }
+
+        /// Invalidates all distances
+        void reset() {
+            m_timestamp++;
+
+            // after a wrap around old entries could look valid again, so they are cleared once
+            if (m_timestamp == 0) {
+                for (auto &entry: m_entries) {
+                    entry.timestamp = 0;
+                }
+                m_timestamp = 1;
+            }
+        }
+
+        [[nodiscard]] int get(const int index) const {
+            const auto &entry = m_entries[index];
+            return entry.timestamp == m_timestamp ? entry.distance : INFINITE_DISTANCE;
+        }
+
+        void set(const int index, const int distance) {
+            m_entries[index] = Entry{distance, m_timestamp};
+        }
+
+    private:
+        struct Entry {
+            int distance;
+            uint32_t timestamp;
+        };
+
+        std::vector<Entry> m_entries;
+        uint32_t m_timestamp = 1;
+    };
+
+    /// Edge a node was reached by in a CH search, the index points into the up or down edges of the searched graph
+    struct ParentEdge {
+        int node;
+        int edge;
+    };
+
+    /// Per-thread memory of a CH query, it is sized once for the graph and reused by all queries,
+    /// so a query only pays for the nodes it touches.
+    template<typename Queue = BinaryHeap>
+    class CHQueryWorkspace {
+    public:
+        explicit CHQueryWorkspace(const int node_count = 0) : up_distances(node_count), down_distances(node_count),
+                                                              up_parents(node_count), down_parents(node_count) {
+            up_queue.reset(node_count);
+            down_queue.reset(node_count);
+        }
+
+        /// Prepares the workspace for a new query on a graph with node_count nodes
+        void reset(const int node_count) {
+            up_distances.resize(node_count);
+            up_distances.reset();
+            down_distances.resize(node_count);
+            down_distances.reset();
+            up_queue.reset(node_count);
+            down_queue.reset(node_count);
+            if (node_count > static_cast<int>(up_parents.size())) {
+                up_parents.resize(node_count);
+                down_parents.resize(node_count);
+            }
+            up_settled_nodes.clear();
+            down_settled_nodes.clear();
+            meeting_node = -1;
+            settled_nodes = 0;
+            stalled_nodes = 0;
+        }
+
+        TimestampedDistances up_distances;
+        TimestampedDistances down_distances;
+        Queue up_queue;
+        Queue down_queue;
+        /// only valid for nodes with a distance in the same direction, the start nodes have none
+        std::vector<ParentEdge> up_parents;
+        std::vector<ParentEdge> down_parents;
+        /// settled nodes of each direction, only filled by the parallel query which joins the searches over them
+        std::vector<int> up_settled_nodes;
+        std::vector<int> down_settled_nodes;
+        /// node on the shortest path where both searches met, -1 if there is no path
+        int meeting_node = -1;
+        /// nodes settled by the last query in both directions together, stalled nodes are not expanded
+        int settled_nodes = 0;
+        int stalled_nodes = 0;
+    };
+} // exercise::two
+
+#endif //QUERY_WORKSPACE_H
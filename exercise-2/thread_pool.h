@@ -0,0 +1,169 @@
+//
+// Created by Jost on 17/10/2026.
+//
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace exercise::two {
+    /// Persistent worker threads for parallel loops over items of very different cost. Every thread starts with an
+    /// equal share of the items and takes them one by one from the front, a thread that runs out steals the back
+    /// half of the share of another thread. Front and back of a share are packed into one atomic, so taking and
+    /// stealing are both a single compare and swap.
+    class WorkStealingPool {
+    public:
+        explicit WorkStealingPool(const int thread_count = static_cast<int>(std::thread::hardware_concurrency()))
+            : m_ranges(std::max(1, thread_count)) {
+            // the calling thread works as thread 0
+            for (int i = 1; i < get_thread_count(); ++i) {
+                m_threads.emplace_back([this, i]() { run_worker(i); });
+            }
+        }
+
+        WorkStealingPool(const WorkStealingPool &) = delete;
+
+        WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+        ~WorkStealingPool() {
+            {
+                const std::lock_guard lock(m_mutex);
+                m_stopping = true;
+            }
+            m_start.notify_all();
+            for (auto &thread: m_threads) {
+                thread.join();
+            }
+        }
+
+        [[nodiscard]] int get_thread_count() const {
+            return static_cast<int>(m_ranges.size());
+        }
+
+        /// Calls function(thread_index, item) for every item in [0, count) and returns once all calls are done.
+        /// The thread index is in [0, get_thread_count()), so per-thread state can be kept in a plain vector
+        template<typename Function>
+        void parallel_for(const int count, const Function &function) {
+            const auto thread_count = get_thread_count();
+            for (int i = 0; i < thread_count; ++i) {
+                m_ranges[i].store(pack(static_cast<long long>(count) * i / thread_count,
+                                       static_cast<long long>(count) * (i + 1) / thread_count));
+            }
+
+            {
+                const std::lock_guard lock(m_mutex);
+                m_job = [&function](const int thread_index, const int item) { function(thread_index, item); };
+                m_running_workers = thread_count - 1;
+                m_generation++;
+            }
+            m_start.notify_all();
+
+            process(0);
+
+            std::unique_lock lock(m_mutex);
+            m_done.wait(lock, [this]() { return m_running_workers == 0; });
+            m_job = nullptr;
+        }
+
+    private:
+        static constexpr int NO_ITEM = -1;
+
+        // one share per thread, [front, back) packed as front << 32 | back
+        std::vector<std::atomic<uint64_t> > m_ranges;
+        std::vector<std::thread> m_threads;
+
+        std::mutex m_mutex;
+        std::condition_variable m_start;
+        std::condition_variable m_done;
+        std::function<void(int, int)> m_job;
+        uint64_t m_generation = 0;
+        int m_running_workers = 0;
+        bool m_stopping = false;
+
+        static uint64_t pack(const long long front, const long long back) {
+            return static_cast<uint64_t>(front) << 32 | static_cast<uint32_t>(back);
+        }
+
+        static int front_of(const uint64_t range) {
+            return static_cast<int>(range >> 32);
+        }
+
+        static int back_of(const uint64_t range) {
+            return static_cast<int>(range & 0xFFFFFFFF);
+        }
+
+        void run_worker(const int thread_index) {
+            uint64_t generation = 0;
+            while (true) {
+                {
+                    std::unique_lock lock(m_mutex);
+                    m_start.wait(lock, [this, generation]() { return m_stopping || m_generation != generation; });
+                    if (m_stopping)
+                        return;
+                    generation = m_generation;
+                }
+
+                process(thread_index);
+
+                const std::lock_guard lock(m_mutex);
+                if (--m_running_workers == 0) {
+                    m_done.notify_one();
+                }
+            }
+        }
+
+        void process(const int thread_index) {
+            while (true) {
+                auto item = take(thread_index);
+                if (item == NO_ITEM) {
+                    item = steal(thread_index);
+                    if (item == NO_ITEM)
+                        return;
+                }
+                m_job(thread_index, item);
+            }
+        }
+
+        /// Next item from the front of the own share
+        int take(const int thread_index) {
+            auto &range = m_ranges[thread_index];
+            auto current = range.load();
+            while (front_of(current) < back_of(current)) {
+                if (range.compare_exchange_weak(current, pack(front_of(current) + 1, back_of(current))))
+                    return front_of(current);
+            }
+            return NO_ITEM;
+        }
+
+        /// Moves the back half of another share into the own one and returns its first item,
+        /// NO_ITEM once all shares are empty
+        int steal(const int thread_index) {
+            const auto thread_count = get_thread_count();
+            for (int offset = 1; offset < thread_count; ++offset) {
+                auto &victim = m_ranges[(thread_index + offset) % thread_count];
+                auto current = victim.load();
+                while (front_of(current) < back_of(current)) {
+                    const auto front = front_of(current);
+                    const auto back = back_of(current);
+                    const auto middle = back - (back - front + 1) / 2;
+                    if (victim.compare_exchange_weak(current, pack(front, middle))) {
+                        // only the owner writes into an empty share, thieves skip it
+                        m_ranges[thread_index].store(pack(middle + 1, back));
+                        return middle;
+                    }
+                }
+            }
+            return NO_ITEM;
+        }
+    };
+} // exercise::two
+
+#endif //THREAD_POOL_H
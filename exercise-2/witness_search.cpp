@@ -0,0 +1,67 @@
+//
+// Created by Jost on 17/10/2026.
+//
+
+#include "witness_search.h"
+
+namespace exercise::two {
+    template<typename Queue>
+    WitnessSearch<Queue>::WitnessSearch(const ContractionGraph &graph, const WitnessSearchLimits limits)
+        : m_graph(graph), m_limits(limits), m_distances(graph.get_node_count()), m_hops(graph.get_node_count()) {
+        m_queue.reset(graph.get_node_count());
+    }
+
+    template<typename Queue>
+    void WitnessSearch<Queue>::run(const int source, const int excluded_node, const int max_distance) {
+        m_distances.reset();
+        m_queue.reset(m_graph.get_node_count());
+        m_statistics.searches++;
+
+        m_distances.set(source, 0);
+        m_hops[source] = 0;
+        m_queue.push(source, 0);
+
+        int settled_nodes = 0;
+        while (!m_queue.empty()) {
+            const auto [index, distance] = m_queue.pop();
+
+            // old invalid entry, not removed for performance
+            if (distance > m_distances.get(index)) {
+                continue;
+            }
+
+            // all remaining paths are longer than the path over the excluded node
+            if (distance > max_distance) {
+                break;
+            }
+
+            if (settled_nodes == m_limits.settle_limit) {
+                m_statistics.settle_limit_hits++;
+                break;
+            }
+            settled_nodes++;
+
+            if (m_hops[index] == m_limits.hop_limit) {
+                continue;
+            }
+
+            for (const auto [neighbour, weight]: m_graph.get_out_edges(index)) {
+                if (neighbour == excluded_node) {
+                    continue;
+                }
+
+                if (const auto new_distance = distance + weight; new_distance < m_distances.get(neighbour)) {
+                    m_distances.set(neighbour, new_distance);
+                    m_hops[neighbour] = m_hops[index] + 1;
+                    m_queue.push(neighbour, new_distance);
+                }
+            }
+        }
+
+        m_statistics.settled_nodes += settled_nodes;
+    }
+
+    template class WitnessSearch<BinaryHeap>;
+    template class WitnessSearch<QuaternaryHeap>;
+    template class WitnessSearch<RadixHeap>;
+} // exercise::two
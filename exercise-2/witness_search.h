@@ -0,0 +1,73 @@
+//
+// Created by Jost on 17/10/2026.
+//
+
+#ifndef WITNESS_SEARCH_H
+#define WITNESS_SEARCH_H
+
+#include <vector>
+
+#include "contraction_graph.h"
+#include "priority_queues.h"
+#include "query_workspace.h"
+
+namespace exercise::two {
+    /// Bounds for a single witness search. A search that hits a limit may miss a witness, that only costs
+    /// an unnecessary shortcut, never a wrong distance
+    struct WitnessSearchLimits {
+        int settle_limit = 1000;
+        int hop_limit = 8;
+    };
+
+    struct WitnessSearchStatistics {
+        long long searches = 0;
+        long long settled_nodes = 0;
+        long long settle_limit_hits = 0;
+
+        WitnessSearchStatistics &operator+=(const WitnessSearchStatistics &other) {
+            searches += other.searches;
+            settled_nodes += other.settled_nodes;
+            settle_limit_hits += other.settle_limit_hits;
+            return *this;
+        }
+    };
+
+    /// One-to-many Dijkstra on the remaining graph that searches for paths around the node being contracted.
+    /// Instantiated for the BinaryHeap, QuaternaryHeap and RadixHeap queues
+    template<typename Queue = BinaryHeap>
+    class WitnessSearch {
+    public:
+        explicit WitnessSearch(const ContractionGraph &graph, WitnessSearchLimits limits = {});
+
+        /// Searches from source without passing the excluded node, nodes farther away than max_distance are
+        /// not settled
+        void run(int source, int excluded_node, int max_distance);
+
+        /// Length of a path from the source of the last run, it is only an upper bound if the search was
+        /// stopped early. TimestampedDistances::INFINITE_DISTANCE if the node wasn't reached
+        [[nodiscard]] int get_distance(const int node) const {
+            return m_distances.get(node);
+        }
+
+        [[nodiscard]] const WitnessSearchStatistics &statistics() const {
+            return m_statistics;
+        }
+
+        void reset_statistics() {
+            m_statistics = WitnessSearchStatistics{};
+        }
+
+    private:
+        const ContractionGraph &m_graph;
+        WitnessSearchLimits m_limits;
+
+        TimestampedDistances m_distances;
+        // only valid for nodes with a distance in the current search
+        std::vector<int> m_hops;
+        Queue m_queue;
+
+        WitnessSearchStatistics m_statistics;
+    };
+} // exercise::two
+
+#endif //WITNESS_SEARCH_H
@@ -41,43 +41,33 @@ namespace Sheet3 {
             );
             std::sort(elements_b.begin(), elements_b.end());
 
-            std::stringstream naive_time_str;
-            {
+            // every intersection has to find all elements of b, as b is a sample of a
+            const auto time_intersection = [&sw, &elements_a, &elements_b](const auto &intersect) {
+                std::stringstream time_str;
                 sw.Restart();
-                const auto naive_result = intersect_naive(elements_a, elements_b);
-                const auto naive_time = sw.Split();
-                if (naive_result.size() == elements_b.size())
-                    naive_time_str << std::fixed << std::setprecision(2) << naive_time << "us";
+                const auto result = intersect(elements_a, elements_b);
+                const auto time = sw.Split();
+                if (result.size() == elements_b.size())
+                    time_str << std::fixed << std::setprecision(2) << time << "us";
                 else
-                    naive_time_str << "Failed";
-            }
+                    time_str << "Failed";
+                return time_str.str();
+            };
 
-            std::stringstream binary_time_str;
-            {
-                sw.Restart();
-                const auto binary_result = intersect_binary(elements_a, elements_b);
-                const auto binary_time = sw.Split();
-                if (binary_result.size() == elements_b.size())
-                    binary_time_str << std::fixed << std::setprecision(2) << binary_time << "us";
-                else
-                    binary_time_str << "Failed";
-            }
-
-            std::stringstream galloping_time_str;
-            {
-                sw.Restart();
-                const auto galloping_result = intersect_galloping(elements_a, elements_b);
-                const auto galloping_time = sw.Stop();
-                if (galloping_result.size() == elements_b.size())
-                    galloping_time_str << std::fixed << std::setprecision(2) << galloping_time << "us";
-                else
-                    galloping_time_str << "Failed";
-            }
+            const auto naive_time_str = time_intersection(intersect_naive);
+            const auto binary_time_str = time_intersection(intersect_binary);
+            const auto galloping_time_str = time_intersection(intersect_galloping);
+            const auto simd_block_time_str = time_intersection(intersect_simd_block);
+            const auto simd_galloping_time_str = time_intersection(intersect_simd_galloping);
+            const auto simd_time_str = time_intersection(intersect_simd);
 
             std::cout << "[BENCHMARK] "
-                      << "Naive: " << std::left << std::setw(12) << naive_time_str.str()
-                      << "Binary: " << std::left << std::setw(12) << binary_time_str.str()
-                      << "Galloping: " << std::left << std::setw(12) << galloping_time_str.str()
+                      << "Naive: " << std::left << std::setw(12) << naive_time_str
+                      << "Binary: " << std::left << std::setw(12) << binary_time_str
+                      << "Galloping: " << std::left << std::setw(12) << galloping_time_str
+                      << "SIMD block: " << std::left << std::setw(12) << simd_block_time_str
+                      << "SIMD galloping: " << std::left << std::setw(12) << simd_galloping_time_str
+                      << "SIMD dispatch: " << std::left << std::setw(12) << simd_time_str
                       << " for " << elements_b.size() << " Elements"
                       << std::endl;
         }
@@ -5,10 +5,20 @@
 #pragma once
 
 #include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <cmath>
 #include <vector>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+// the AVX2 kernel is compiled for its own target and only called if the CPU supports it
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SHEET3_HAS_AVX2_KERNEL
+#include <immintrin.h>
+#endif
+
 namespace Sheet3 {
     inline std::vector<uint32_t> intersect_naive(const std::vector<uint32_t> &v1, const std::vector<uint32_t> &v2) {
         std::vector<uint32_t> result;
@@ -146,4 +156,263 @@ namespace Sheet3 {
 
         return result;
     }
+
+    // Kernels below write the common elements of two sorted lists of unique values into out, which needs room for
+    // min(size_a, size_b) elements, and return the number of elements written.
+
+    // plain merge, used for whatever the block kernels leave over
+    inline size_t intersect_scalar_kernel(const uint32_t *a, size_t size_a, const uint32_t *b, size_t size_b,
+                                          uint32_t *out) {
+        size_t count = 0;
+        size_t i = 0;
+        size_t j = 0;
+        while (i < size_a && j < size_b) {
+            if (a[i] < b[j]) {
+                i++;
+            } else if (b[j] < a[i]) {
+                j++;
+            } else {
+                out[count++] = a[i];
+                i++;
+                j++;
+            }
+        }
+        return count;
+    }
+
+#if defined(__SSE2__) || defined(SHEET3_HAS_AVX2_KERNEL)
+    // writes the elements of the block whose bit is set in the mask
+    inline size_t store_matches(const uint32_t *block, uint32_t mask, uint32_t *out) {
+        size_t count = 0;
+        while (mask != 0) {
+            out[count++] = block[__builtin_ctz(mask)];
+            mask &= mask - 1;
+        }
+        return count;
+    }
+#endif
+
+#if defined(__SSE2__)
+    // Compares a block of 4 elements of a with all 4 rotations of a block of b. The block with the smaller last
+    // element can't match anything behind the other block and is skipped, both are skipped if the last elements
+    // are equal.
+    inline size_t intersect_sse_kernel(const uint32_t *a, const size_t size_a, const uint32_t *b, const size_t size_b,
+                                       uint32_t *out) {
+        size_t count = 0;
+        size_t i = 0;
+        size_t j = 0;
+        while (i + 4 <= size_a && j + 4 <= size_b) {
+            const auto block_a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+            const auto block_b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + j));
+            auto equal = _mm_cmpeq_epi32(block_a, block_b);
+            equal = _mm_or_si128(equal, _mm_cmpeq_epi32(block_a, _mm_shuffle_epi32(block_b, _MM_SHUFFLE(0, 3, 2, 1))));
+            equal = _mm_or_si128(equal, _mm_cmpeq_epi32(block_a, _mm_shuffle_epi32(block_b, _MM_SHUFFLE(1, 0, 3, 2))));
+            equal = _mm_or_si128(equal, _mm_cmpeq_epi32(block_a, _mm_shuffle_epi32(block_b, _MM_SHUFFLE(2, 1, 0, 3))));
+            count += store_matches(a + i, _mm_movemask_ps(_mm_castsi128_ps(equal)), out + count);
+
+            const auto last_a = a[i + 3];
+            const auto last_b = b[j + 3];
+            i += (last_a <= last_b) * 4;
+            j += (last_b <= last_a) * 4;
+        }
+        return count + intersect_scalar_kernel(a + i, size_a - i, b + j, size_b - j, out + count);
+    }
+#endif
+
+#if defined(SHEET3_HAS_AVX2_KERNEL)
+    // same as the SSE kernel with blocks of 8 elements and 8 rotations
+    __attribute__((target("avx2")))
+    inline size_t intersect_avx2_kernel(const uint32_t *a, const size_t size_a, const uint32_t *b,
+                                        const size_t size_b, uint32_t *out) {
+        const auto rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+        size_t count = 0;
+        size_t i = 0;
+        size_t j = 0;
+        while (i + 8 <= size_a && j + 8 <= size_b) {
+            const auto block_a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+            auto block_b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + j));
+            auto equal = _mm256_cmpeq_epi32(block_a, block_b);
+            for (int rotation = 1; rotation < 8; ++rotation) {
+                block_b = _mm256_permutevar8x32_epi32(block_b, rotate);
+                equal = _mm256_or_si256(equal, _mm256_cmpeq_epi32(block_a, block_b));
+            }
+            count += store_matches(a + i, _mm256_movemask_ps(_mm256_castsi256_ps(equal)), out + count);
+
+            const auto last_a = a[i + 7];
+            const auto last_b = b[j + 7];
+            i += (last_a <= last_b) * 8;
+            j += (last_b <= last_a) * 8;
+        }
+        return count + intersect_scalar_kernel(a + i, size_a - i, b + j, size_b - j, out + count);
+    }
+
+    inline bool cpu_supports_avx2() {
+        static const bool supported = __builtin_cpu_supports("avx2");
+        return supported;
+    }
+#endif
+
+    // elements of the larger list compared at once after galloping
+    constexpr size_t GALLOPING_BLOCK_SIZE = 16;
+
+    // For every element of the small list the large list is galloped in blocks of 16 elements by their last
+    // element, the block that can contain the element is then compared at once. Blocks before the found one are
+    // never looked at again, the last incomplete block is merged.
+    inline size_t intersect_galloping_simd_kernel(const uint32_t *small, const size_t size_small,
+                                                  const uint32_t *large, const size_t size_large, uint32_t *out) {
+        size_t count = 0;
+        size_t lower = 0;
+        size_t k = 0;
+        for (; k < size_small; ++k) {
+            const auto value = small[k];
+            const auto block_count = (size_large - lower) / GALLOPING_BLOCK_SIZE;
+            const auto block_last = [large, lower](const size_t block) {
+                return large[lower + (block + 1) * GALLOPING_BLOCK_SIZE - 1];
+            };
+            if (block_count == 0)
+                break;
+
+            // first block whose last element isn't smaller than the value, block_count if there is none
+            size_t found = 0;
+            if (block_last(0) < value) {
+                size_t below = 0;
+                size_t above = 1;
+                while (above < block_count && block_last(above) < value) {
+                    below = above;
+                    above *= 2;
+                }
+                above = std::min(above, block_count);
+                while (above - below > 1) {
+                    const auto middle = below + (above - below) / 2;
+                    if (block_last(middle) < value) {
+                        below = middle;
+                    } else {
+                        above = middle;
+                    }
+                }
+                found = above;
+            }
+            lower += found * GALLOPING_BLOCK_SIZE;
+            if (found == block_count)
+                break;
+
+            const auto *block = large + lower;
+#if defined(__SSE2__)
+            const auto broadcast = _mm_set1_epi32(static_cast<int>(value));
+            auto equal = _mm_cmpeq_epi32(broadcast, _mm_loadu_si128(reinterpret_cast<const __m128i *>(block)));
+            equal = _mm_or_si128(equal, _mm_cmpeq_epi32(broadcast,
+                                                        _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + 4))));
+            equal = _mm_or_si128(equal, _mm_cmpeq_epi32(broadcast,
+                                                        _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + 8))));
+            equal = _mm_or_si128(equal, _mm_cmpeq_epi32(broadcast,
+                                                        _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + 12))));
+            if (_mm_movemask_epi8(equal) != 0) {
+                out[count++] = value;
+            }
+#else
+            if (std::binary_search(block, block + GALLOPING_BLOCK_SIZE, value)) {
+                out[count++] = value;
+            }
+#endif
+        }
+        return count + intersect_scalar_kernel(small + k, size_small - k, large + lower, size_large - lower,
+                                               out + count);
+    }
+
+    // lists that differ more in size are intersected by galloping, the block kernels scan both lists completely.
+    // In the benchmark of exercise one galloping already wins at half the size
+    constexpr size_t SIMD_GALLOPING_RATIO = 2;
+
+    inline std::vector<uint32_t> intersect_simd_block(const std::vector<uint32_t> &v1, const std::vector<uint32_t> &v2) {
+        std::vector<uint32_t> result(std::min(v1.size(), v2.size()));
+        size_t count;
+#if defined(SHEET3_HAS_AVX2_KERNEL)
+        if (cpu_supports_avx2()) {
+            count = intersect_avx2_kernel(v1.data(), v1.size(), v2.data(), v2.size(), result.data());
+        } else
+#endif
+        {
+#if defined(__SSE2__)
+            count = intersect_sse_kernel(v1.data(), v1.size(), v2.data(), v2.size(), result.data());
+#else
+            count = intersect_scalar_kernel(v1.data(), v1.size(), v2.data(), v2.size(), result.data());
+#endif
+        }
+        result.resize(count);
+        return result;
+    }
+
+    inline std::vector<uint32_t> intersect_simd_galloping(const std::vector<uint32_t> &v1,
+                                                          const std::vector<uint32_t> &v2) {
+        const auto &small = v1.size() <= v2.size() ? v1 : v2;
+        const auto &large = v1.size() <= v2.size() ? v2 : v1;
+        std::vector<uint32_t> result(small.size());
+        result.resize(intersect_galloping_simd_kernel(small.data(), small.size(), large.data(), large.size(),
+                                                      result.data()));
+        return result;
+    }
+
+    // picks the kernel by the size ratio of the lists, the block kernel uses AVX2 where the CPU supports it
+    inline std::vector<uint32_t> intersect_simd(const std::vector<uint32_t> &v1, const std::vector<uint32_t> &v2) {
+        const auto small_size = std::min(v1.size(), v2.size());
+        const auto large_size = std::max(v1.size(), v2.size());
+        if (large_size / std::max<size_t>(1, small_size) >= SIMD_GALLOPING_RATIO)
+            return intersect_simd_galloping(v1, v2);
+
+        return intersect_simd_block(v1, v2);
+    }
+
+    // first position at or behind start whose element isn't smaller than the value, the size if there is none
+    inline size_t gallop_to(const std::vector<uint32_t> &list, const size_t start, const uint32_t value) {
+        if (start >= list.size() || list[start] >= value)
+            return start;
+
+        // list[start + jump / 2] < value, so the element is behind it and at most at start + jump
+        size_t jump = 1;
+        while (start + jump < list.size() && list[start + jump] < value) {
+            jump <<= 1;
+        }
+        const auto first = list.begin() + static_cast<std::ptrdiff_t>(start + jump / 2 + 1);
+        const auto last = list.begin() + static_cast<std::ptrdiff_t>(std::min(start + jump + 1, list.size()));
+        return static_cast<size_t>(std::lower_bound(first, last, value) - list.begin());
+    }
+
+    // Intersects all lists at once: the shortest list drives, every candidate is galloped to in the other lists,
+    // shortest first, from where the last candidate was found. A larger element in another list becomes the next
+    // candidate, so the driver gallops over everything in between. Stops as soon as any list is exhausted.
+    inline std::vector<uint32_t> intersect_k_way(std::vector<const std::vector<uint32_t> *> lists) {
+        if (lists.empty())
+            return {};
+
+        std::sort(lists.begin(), lists.end(), [](const auto *a, const auto *b) { return a->size() < b->size(); });
+        const auto &driver = *lists[0];
+
+        std::vector<uint32_t> result;
+        result.reserve(driver.size());
+        std::vector<size_t> positions(lists.size(), 0);
+        size_t i = 0;
+        while (i < driver.size()) {
+            const auto candidate = driver[i];
+            bool found = true;
+            for (size_t l = 1; l < lists.size(); ++l) {
+                const auto &list = *lists[l];
+                positions[l] = gallop_to(list, positions[l], candidate);
+                if (positions[l] == list.size())
+                    return result;
+
+                if (list[positions[l]] != candidate) {
+                    i = gallop_to(driver, i + 1, list[positions[l]]);
+                    found = false;
+                    break;
+                }
+            }
+
+            if (found) {
+                result.push_back(candidate);
+                i++;
+            }
+        }
+
+        return result;
+    }
 } // Sheet3
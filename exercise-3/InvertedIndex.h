@@ -10,6 +10,8 @@
 #include <unordered_map>
 #include <map>
 
+#include "Intersect.h"
+
 namespace Sheet3 {
     struct Movie {
         std::string title;
@@ -68,33 +70,27 @@ namespace Sheet3 {
         }
 
         std::vector<uint32_t> search(const std::string &query) const {
-            bool is_first = true;
-            std::vector<uint32_t> results;
+            std::vector<const std::vector<uint32_t> *> lists;
 
             std::stringstream words_stream(normalize_line(query));
             std::string word;
             while (words_stream >> word) {
-                if (is_first) {
-                    auto entry = m_Index.find(word);
-                    if (entry == m_Index.end())
-                        return {};
-
-                    results = entry->second;
-                    is_first = false;
-                    continue;
-                }
-
                 auto entry = m_Index.find(word);
                 if (entry == m_Index.end())
                     return {};
 
-                results = intersect_galloping(results, entry->second);
-
-                if (results.empty())
-                    return {};
+                lists.push_back(&entry->second);
             }
 
-            return results;
+            if (lists.empty())
+                return {};
+            if (lists.size() == 1)
+                return *lists[0];
+            // two lists are faster with the SIMD kernels, more are intersected in one pass without intermediate results
+            if (lists.size() == 2)
+                return intersect_simd(*lists[0], *lists[1]);
+
+            return intersect_k_way(std::move(lists));
         }
 
     private: